@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace Decay
+{
+	/// Keeps track of the next deadline for a fixed set of entries (e.g. skills), keyed on days passed.
+	///
+	/// Each entry can have at most one pending deadline. Deadlines are stored in an indexed binary min-heap,
+	/// so checking whether anything is due is O(1), while scheduling and popping an entry is O(log N).
+	class DeadlineScheduler
+	{
+	public:
+		using Entry = std::uint32_t;
+
+		/// Deadline of entries that are not scheduled.
+		static constexpr float never = std::numeric_limits<float>::infinity();
+
+		explicit DeadlineScheduler(std::size_t capacity);
+
+		/// Sets a deadline for the entry, replacing previous deadline if it was already scheduled.
+		void Schedule(Entry entry, float deadline);
+
+		/// Removes pending deadline of the entry, if any.
+		void Cancel(Entry entry);
+
+		/// Removes all pending deadlines.
+		void Clear();
+
+		bool IsScheduled(Entry entry) const { return positions[entry] != unscheduled; }
+
+		/// Deadline of the entry or `never` if it is not scheduled.
+		float GetDeadline(Entry entry) const { return IsScheduled(entry) ? deadlines[entry] : never; }
+
+		/// The earliest pending deadline or `never` if nothing is scheduled.
+		float GetNextDeadline() const { return heap.empty() ? never : deadlines[heap.front()]; }
+
+		/// Checks whether any of the entries is due at given time.
+		bool IsDue(float now) const { return GetNextDeadline() <= now; }
+
+		/// Removes and returns the entry with the earliest deadline, if it is due at given time.
+		std::optional<Entry> PopDue(float now);
+
+		std::size_t GetCapacity() const { return deadlines.size(); }
+		std::size_t GetSize() const { return heap.size(); }
+
+	private:
+		static constexpr std::size_t unscheduled = std::numeric_limits<std::size_t>::max();
+
+		/// Deadlines indexed by entry.
+		std::vector<float> deadlines;
+
+		/// Position of each entry in the heap or `unscheduled`.
+		std::vector<std::size_t> positions;
+
+		/// Min-heap of scheduled entries ordered by their deadlines.
+		std::vector<Entry> heap;
+
+		void Remove(std::size_t position);
+		void SiftUp(std::size_t position);
+		void SiftDown(std::size_t position);
+		void Place(std::size_t position, Entry entry);
+
+		bool IsEarlier(Entry lhs, Entry rhs) const { return deadlines[lhs] < deadlines[rhs]; }
+	};
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+// Kernel translation units are compiled with instruction set specific flags, so everything they include
+// must be free of inline functions that could end up shared with the rest of the program.
+// That's why this header has no other dependencies.
+
+#include <cstddef>
+
+namespace Decay
+{
+	/// Number of skills in the game.
+	constexpr std::size_t skillCount = 18;
+
+	/// Inputs of SkillUsage's decay XP formula for a batch of skills, laid out as structure of arrays.
+	///
+	/// All values are already resolved (e.g. automatic difficulty mult is replaced with the actual multiplier).
+	/// Lanes past the last skill are padding and are initialized to values that are safe to evaluate.
+	struct DecayBatch
+	{
+		/// Number of lanes in the batch: skillCount rounded up to the width of the widest supported SIMD register.
+		static constexpr std::size_t size = (skillCount + 7) / 8 * 8;
+
+		/// Hours passed since the last decay of the skill.
+		alignas(32) float hoursPassed[size];
+		alignas(32) float interval[size];
+		alignas(32) float difficultyMult[size];
+		alignas(32) float damping[size];
+
+		/// Legendary damping of the skill, according to its legendary level.
+		alignas(32) float legendaryMult[size];
+
+		/// Level whose XP threshold defines the decay rate.
+		alignas(32) float targetLevel[size];
+
+		alignas(32) float improveMult[size];
+		alignas(32) float improveOffset[size];
+		alignas(32) float curve[size];
+
+		alignas(32) float minDaysPerLevel[size];
+		alignas(32) float maxDaysPerLevel[size];
+
+		DecayBatch();
+	};
+}
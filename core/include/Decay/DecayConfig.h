@@ -1,7 +1,8 @@
-#include "RE/C/Calendar.h"
+#pragma once
 
 namespace Decay
 {
+	/// Parameters of the decay model for a single skill.
 	struct DecayConfig
 	{
 		/// Time interval in hours before a skill is considered stale (starting to decay).
@@ -62,90 +63,9 @@ namespace Decay
 		/// This value is used to clamp minimum allowed decay XP, to prevent too slow decays on higher levels.
 		float maxDaysPerLevel = 14.0f;
 
-		/// Paths to the skill level meter UI elements for each skill, used for applying color tint when decaying.
-		std::vector<std::string> uiLayers;
-
-		/// Color of the tint to be applied to the skill level meter UI elements when the skill is decaying.
-		RE::GColor decayTint = { 255, 60, 0, 200 };
-
-		/// Color of the tint to be applied to the skill level meter UI elements when the skill is not decaying.
-		/// Provided just for fun if some people would like to recolor their skill meters.
-		RE::GColor normalTint = { 0, 0, 0, 0 };
-
 		DecayConfig() = default;
-		DecayConfig(std::vector<std::string> layers) :
-			uiLayers(std::move(layers))
-		{}
-		DecayConfig(float damping, std::vector<std::string> layers) :
-			damping(damping),
-			uiLayers(std::move(layers))
+		DecayConfig(float damping) :
+			damping(damping)
 		{}
 	};
-
-	struct SkillUsage
-	{
-		void Init(Skill skill, DecayConfig& config);
-		void Revert();
-
-		/// Checks whether this SkillUsage has received at least one SetUsed() call.
-		bool IsInitialized() const;
-
-		bool WasUsed() const;
-		void SetUsed(const RE::Calendar* calendar);
-
-		bool IsStale(const RE::Calendar* calendar) const;
-
-		void MarkDecaying(const RE::Calendar* calendar);
-		bool IsDecaying() const;
-		void Decay(const RE::Calendar*);
-
-		int GetDecayCapLevel() const;
-
-		const DecayConfig& GetConfig() const { return decay; }
-
-	private:
-		Skill skill = Skill::kTotal;  // unless loaded properly, this SkillUsage is invalid and should not be used.
-
-		/// Days Passed when the skill was last used.
-		float daysPassedWhenLastUsed = 0;
-
-		int   lastKnownLevel = -1;
-		float lastKnownXP = -1;
-
-		int lastKnownLegendaryLevel = -1;
-
-		/// Highest level achieved in this skill, used for relative decay cap when decayCap is negative.
-		int lastKnownHighestLevel = -1;
-
-		bool  isDecaying = false;
-		float daysPassedSinceLastDecay = 0;
-
-		/// Starting level of the skill.
-		int baselineLevel = 15;
-
-		/// Bonus that Player's race provides to the skill.
-		/// Together with baselineLevel is used to calculate XP decay rate for the skill.
-		/// Also, used to prevent decaying below (baselineLevel + raceSkillBonus).
-		int raceSkillBonus = 0;
-
-		DecayConfig decay;
-
-		/// Subtracts decayXPAmount recursively, decreasing skill level as needed.
-		void DecaySkill(SkillData& skillData, float& decayXPAmount);
-
-		int   GetStartingLevel() const;
-		int   GetDecayTargetLevel() const;
-		float GetDifficultyMult() const;
-
-		float GetGracePeriod() const;
-
-		float GetLegendaryMult() const;
-
-		int GetDifficulty() const;
-
-		float CalculateLevelThresholdXP(int level) const;
-
-		friend bool Write(SKSE::SerializationInterface*, const SkillUsage&);
-		friend bool Read(SKSE::SerializationInterface*, SkillUsage&);
-	};
 }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Decay/DecayBatch.h"
+#include <cstddef>
+
+namespace Decay
+{
+	/// Instruction sets that the decay kernel is implemented with.
+	enum class DecayKernelIsa
+	{
+		kScalar,
+		kSSE4,
+		kAVX2
+	};
+
+	/// The widest instruction set supported by the CPU.
+	DecayKernelIsa GetSupportedDecayKernelIsa();
+
+	const char* GetDecayKernelIsaName(DecayKernelIsa isa);
+
+	/// Upper bound of the relative error of the kernel's pow() compared to the exact result,
+	/// for x in [1, 254] and y in [0.5, 4], which covers level thresholds of all levels with any sensible fSkillUseCurve.
+	///
+	/// pow is evaluated as exp2(y * log2(x)) with polynomial approximations of log2 and exp2.
+	/// Both polynomials are accurate to about 1e-8, so the error is dominated by rounding of y * log2(x),
+	/// which is amplified by ln(2) * |y * log2(x)| ulp and amounts to ~1e-6 at the top of the range.
+	constexpr float decayKernelPowError = 2e-6f;
+
+	/// Calculates decay XP for all lanes of the batch using the given instruction set, which must be supported by the CPU.
+	///
+	/// All instruction sets produce identical results, which differ from CalculateDecayXPReference()
+	/// only by the error of pow() (see decayKernelPowError).
+	void CalculateDecayXP(const DecayBatch& batch, float (&decayXP)[DecayBatch::size], DecayKernelIsa isa = GetSupportedDecayKernelIsa());
+
+	/// Calculates decay XP one lane at a time exactly like SkillUsage::Decay() does.
+	void CalculateDecayXPReference(const DecayBatch& batch, float (&decayXP)[DecayBatch::size]);
+
+	/// Calculates x^y for count elements using the kernel's approximation of pow().
+	/// x must be non-negative.
+	void CalculatePow(const float* x, const float* y, float* result, std::size_t count, DecayKernelIsa isa = GetSupportedDecayKernelIsa());
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Decay/SkillUsage.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+
+/// Binary journal of a play session, recorded by the plugin for offline inspection of how skills have changed.
+///
+/// A journal is a JournalHeader followed by fixed-size JournalRecords in the order they were recorded:
+///
+///     kTick  - in-game time has advanced by delta days
+///     kSkill - state of a skill after it was updated or used, along with the transition it went through, if any
+///     kReset - skills were reset when a save was loaded, so time might have jumped back
+///
+/// Values are stored in the native (little-endian) layout of the structs below.
+namespace Decay
+{
+	constexpr std::uint32_t journalSignature = 'S' << 24 | 'K' << 16 | 'D' << 8 | 'J';
+	constexpr std::uint32_t journalVersion = 1;
+
+	struct JournalHeader
+	{
+		std::uint32_t signature = journalSignature;
+		std::uint32_t version = journalVersion;
+		std::uint32_t recordSize = 0;
+		std::uint32_t skillCount = 0;
+
+		/// Real time when the session started, in seconds since the Unix epoch.
+		std::int64_t startTime = 0;
+
+		std::uint32_t reserved[2]{};
+	};
+	static_assert(sizeof(JournalHeader) == 32);
+
+	struct JournalRecord
+	{
+		enum class Type : std::uint8_t
+		{
+			kTick,
+			kSkill,
+			kReset
+		};
+
+		Type         type = Type::kTick;
+		std::uint8_t skill = 0;
+		SkillEvent   event = SkillEvent::kNone;
+		std::uint8_t reserved = 0;
+
+		/// In-game days passed when the record was made.
+		float daysPassed = 0.0f;
+
+		/// Level and decay cap level of the skill. Only used by kSkill records.
+		std::int16_t level = 0;
+		std::int16_t capLevel = 0;
+
+		union
+		{
+			/// In-game days passed since the previous kTick record.
+			float delta = 0.0f;
+
+			/// XP of the skill towards the next level.
+			float xp;
+		};
+	};
+	static_assert(sizeof(JournalRecord) == 16);
+
+	/// Appends records to a journal file.
+	///
+	/// Records are collected in a fixed buffer and only written out once it is full or on Flush(),
+	/// so recording is a copy of 16 bytes for all but one in several thousand records.
+	class JournalWriter
+	{
+	public:
+		JournalWriter() = default;
+		~JournalWriter() { Close(); }
+
+		JournalWriter(const JournalWriter&) = delete;
+		JournalWriter& operator=(const JournalWriter&) = delete;
+
+		/// Creates a new journal, replacing the file if it exists.
+		bool Open(const std::filesystem::path& path, std::int64_t startTime);
+
+		/// Flushes buffered records and closes the journal.
+		void Close();
+
+		bool IsOpen() const { return file.is_open(); }
+
+		void RecordTick(float daysPassed, float delta)
+		{
+			JournalRecord record{};
+			record.type = JournalRecord::Type::kTick;
+			record.daysPassed = daysPassed;
+			record.delta = delta;
+			Append(record);
+		}
+
+		void RecordSkill(std::size_t skill, SkillEvent event, float daysPassed, float level, int capLevel, float xp)
+		{
+			JournalRecord record{};
+			record.type = JournalRecord::Type::kSkill;
+			record.skill = static_cast<std::uint8_t>(skill);
+			record.event = event;
+			record.daysPassed = daysPassed;
+			record.level = static_cast<std::int16_t>(level);
+			record.capLevel = static_cast<std::int16_t>(capLevel);
+			record.xp = xp;
+			Append(record);
+		}
+
+		void RecordReset(float daysPassed)
+		{
+			JournalRecord record{};
+			record.type = JournalRecord::Type::kReset;
+			record.daysPassed = daysPassed;
+			Append(record);
+		}
+
+		/// Writes buffered records to the file.
+		/// Returns false if writing has failed, in which case the journal is closed and further records are dropped.
+		bool Flush();
+
+	private:
+		/// Number of buffered records, 64 KiB worth of them.
+		static constexpr std::size_t capacity = 4096;
+
+		std::ofstream                       file;
+		std::array<JournalRecord, capacity> buffer{};
+		std::size_t                         size = 0;
+
+		void Append(const JournalRecord& record)
+		{
+			if (!IsOpen()) {
+				return;
+			}
+			buffer[size++] = record;
+			if (size == capacity) {
+				Flush();
+			}
+		}
+	};
+
+	/// Zero-copy reading of a journal, e.g. from a memory-mapped file.
+	class JournalReader
+	{
+	public:
+		/// Validates the journal's header.
+		/// Returns an empty string on success, otherwise the reason why the journal can't be read.
+		std::string Open(std::span<const std::byte> journal);
+
+		const JournalHeader& GetHeader() const { return header; }
+
+		std::size_t GetRecordCount() const { return records.size() / sizeof(JournalRecord); }
+
+		/// Copies the record out, since nothing guarantees its alignment within the data.
+		JournalRecord GetRecord(std::size_t index) const;
+
+		/// Whether the journal ends with a partially written record, e.g. when the game has crashed while writing it.
+		bool IsTruncated() const { return records.size() % sizeof(JournalRecord) != 0; }
+
+	private:
+		JournalHeader              header{};
+		std::span<const std::byte> records;
+	};
+
+	/// State of the skills reconstructed by replaying journal records in order.
+	struct JournalState
+	{
+		struct SkillEntry
+		{
+			/// Whether any record of the skill was replayed since the last kReset record.
+			bool isKnown = false;
+
+			int   level = 0;
+			int   capLevel = 0;
+			float xp = 0.0f;
+
+			/// The last transition that the skill went through and when it happened.
+			SkillEvent lastEvent = SkillEvent::kNone;
+			float      daysPassedWhenLastEvent = 0.0f;
+
+			/// Number of decay steps and levels lost in them over the whole journal.
+			/// Levels that changed because a save was loaded are not counted.
+			std::uint32_t decaySteps = 0;
+			std::uint32_t levelsLost = 0;
+		};
+
+		float         daysPassed = 0.0f;
+		std::uint32_t resetCount = 0;
+
+		std::array<SkillEntry, skillCount> skills{};
+
+		void Apply(const JournalRecord& record);
+	};
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Decay/SkillState.h"
+#include <array>
+
+namespace Decay
+{
+	/// Lookup table of XP thresholds for each level of a skill.
+	/// The table is rebuilt only when any of the inputs to the skill's leveling formula change.
+	struct LevelThresholds
+	{
+		/// Highest level that is stored in the table. Thresholds for higher levels are calculated on demand.
+		static constexpr int maxLevel = 255;
+
+		/// Rebuilds the table if any of the given parameters differ from the ones the table was built with.
+		/// Returns true when the table was rebuilt.
+		bool Update(const LevelingParams& params);
+
+		float operator[](int level) const;
+
+	private:
+		bool           isBuilt = false;
+		LevelingParams params;
+
+		std::array<float, maxLevel + 1> thresholds{};
+
+		float Calculate(int level) const;
+	};
+}
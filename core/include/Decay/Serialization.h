@@ -0,0 +1,276 @@
+#pragma once
+
+#include "Decay/SkillUsage.h"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Serialization of Skill Decay's data.
+///
+/// Functions are templated on the serialization interface, which must provide
+/// `WriteRecordData(const void*, std::uint32_t)` and `ReadRecordData(void*, std::uint32_t)` like SKSE::SerializationInterface does.
+/// This allows to read and write the same records outside of the game.
+namespace Decay
+{
+	namespace details
+	{
+		/// Packs four characters into a record type the same way MSVC evaluates multi-character literals (e.g. 'SKUS').
+		consteval std::uint32_t FourCC(const char (&code)[5])
+		{
+			return static_cast<std::uint32_t>(code[0]) << 24 | static_cast<std::uint32_t>(code[1]) << 16 | static_cast<std::uint32_t>(code[2]) << 8 | static_cast<std::uint32_t>(code[3]);
+		}
+
+		template <typename Interface, typename T>
+		bool Write(Interface* a_interface, const T& data)
+		{
+			return a_interface->WriteRecordData(&data, sizeof(T));
+		}
+
+		template <typename Interface>
+		bool Write(Interface* a_interface, const std::string& data)
+		{
+			const std::size_t size = data.length();
+			return Write(a_interface, size) && a_interface->WriteRecordData(data.data(), static_cast<std::uint32_t>(size));
+		}
+
+		template <typename Interface, typename T>
+		bool Read(Interface* a_interface, T& result)
+		{
+			return a_interface->ReadRecordData(&result, sizeof(T));
+		}
+
+		template <typename Interface>
+		bool Read(Interface* a_interface, std::string& result)
+		{
+			std::size_t size = 0;
+			if (!Read(a_interface, size)) {
+				return false;
+			}
+			if (size > 0) {
+				result.resize(size);
+				if (!a_interface->ReadRecordData(result.data(), static_cast<std::uint32_t>(size))) {
+					return false;
+				}
+			} else {
+				result = "";
+			}
+			return true;
+		}
+	}
+
+	/// Unique ID of Skill Decay in SKSE co-saves.
+	constexpr std::uint32_t serializationKey = details::FourCC("SKDC");
+
+	/// Type and the current version of the record that stores SkillUsageTable.
+	constexpr std::uint32_t skillUsageRecordType = details::FourCC("SKUS");
+	constexpr std::uint32_t skillUsageVersion = 2;
+
+	/// Reads usage of a single skill from a version 1 record.
+	///
+	/// Version 1 stored each skill in its own record, in the order of skills, with fields written one by one.
+	template <typename Interface>
+	bool Read(Interface* a_interface, SkillUsage usage)
+	{
+		auto&      table = usage.GetTable();
+		const auto skill = usage.skill;
+		return details::Read(a_interface, table.daysPassedWhenLastUsed[skill]) &&
+		       details::Read(a_interface, table.lastKnownLevel[skill]) &&
+		       details::Read(a_interface, table.lastKnownXP[skill]) &&
+		       details::Read(a_interface, table.lastKnownLegendaryLevel[skill]) &&
+		       details::Read(a_interface, table.lastKnownHighestLevel[skill]) &&
+		       details::Read(a_interface, table.isDecaying[skill]) &&
+		       details::Read(a_interface, table.daysPassedSinceLastDecay[skill]);
+	}
+
+	/// Header of a version 2 record.
+	struct SkillUsageRecordHeader
+	{
+		/// Number of entries that follow the header.
+		std::uint32_t count;
+
+		/// Size of each entry. Newer versions may only append fields to SkillUsageRecord,
+		/// so that entries of any size can be read by copying the common part.
+		std::uint32_t entrySize;
+	};
+
+	/// Usage of a single skill in a version 2 record.
+	struct SkillUsageRecord
+	{
+		/// Index of the skill, starting from One-Handed.
+		std::uint32_t skill;
+
+		float        daysPassedWhenLastUsed;
+		float        daysPassedSinceLastDecay;
+		float        lastKnownXP;
+		std::int32_t lastKnownLevel;
+		std::int32_t lastKnownLegendaryLevel;
+		std::int32_t lastKnownHighestLevel;
+		std::uint8_t isDecaying;
+		std::uint8_t reserved[3];
+	};
+
+	static_assert(sizeof(SkillUsageRecordHeader) == 8);
+	static_assert(sizeof(SkillUsageRecord) == 32);
+	static_assert(std::is_trivially_copyable_v<SkillUsageRecord>);
+
+	/// Converts usage of all skills to version 2 entries, ordered by skill.
+	inline std::array<SkillUsageRecord, skillCount> MakeSkillUsageRecords(const SkillUsageTable& table)
+	{
+		std::array<SkillUsageRecord, skillCount> entries{};
+		for (std::uint32_t skill = 0; skill < skillCount; ++skill) {
+			auto& entry = entries[skill];
+			entry.skill = skill;
+			entry.daysPassedWhenLastUsed = table.daysPassedWhenLastUsed[skill];
+			entry.daysPassedSinceLastDecay = table.daysPassedSinceLastDecay[skill];
+			entry.lastKnownXP = table.lastKnownXP[skill];
+			entry.lastKnownLevel = table.lastKnownLevel[skill];
+			entry.lastKnownLegendaryLevel = table.lastKnownLegendaryLevel[skill];
+			entry.lastKnownHighestLevel = table.lastKnownHighestLevel[skill];
+			entry.isDecaying = table.isDecaying[skill];
+		}
+		return entries;
+	}
+
+	/// Writes usage of all skills as a version 2 record:
+	/// SkillUsageRecordHeader followed by a packed array of SkillUsageRecord, written with a single call.
+	template <typename Interface>
+	bool Write(Interface* a_interface, const SkillUsageTable& table)
+	{
+		struct
+		{
+			SkillUsageRecordHeader                   header;
+			std::array<SkillUsageRecord, skillCount> entries;
+		} record{ { skillCount, sizeof(SkillUsageRecord) }, MakeSkillUsageRecords(table) };
+
+		static_assert(sizeof(record) == sizeof(SkillUsageRecordHeader) + sizeof(SkillUsageRecord) * skillCount);
+		return a_interface->WriteRecordData(&record, sizeof(record));
+	}
+
+	/// Reads usage of skills from a version 2 record of the given length, reading the whole record with a single call.
+	///
+	/// Entries are matched to skills by their ID, so they may come in any order.
+	/// Entries of unknown skills are ignored, while skills without an entry are left untouched.
+	/// loaded is set for each skill that was read from the record.
+	template <typename Interface>
+	bool Read(Interface* a_interface, SkillUsageTable& table, std::uint32_t length, std::bitset<skillCount>& loaded)
+	{
+		// Entries must at least contain all fields of the first version of the record.
+		constexpr std::uint32_t minEntrySize = offsetof(SkillUsageRecord, isDecaying) + sizeof(SkillUsageRecord::isDecaying);
+
+		loaded.reset();
+		if (length < sizeof(SkillUsageRecordHeader)) {
+			return false;
+		}
+
+		std::vector<std::byte> data(length);
+		if (!a_interface->ReadRecordData(data.data(), length)) {
+			return false;
+		}
+
+		SkillUsageRecordHeader header;
+		std::memcpy(&header, data.data(), sizeof(header));
+		if (header.entrySize < minEntrySize || header.count > (length - sizeof(header)) / header.entrySize) {
+			return false;
+		}
+
+		const auto* entryData = data.data() + sizeof(header);
+		for (std::uint32_t i = 0; i < header.count; ++i, entryData += header.entrySize) {
+			SkillUsageRecord entry{};
+			std::memcpy(&entry, entryData, std::min<std::size_t>(header.entrySize, sizeof(entry)));
+
+			const auto skill = entry.skill;
+			if (skill >= skillCount) {
+				continue;
+			}
+
+			table.daysPassedWhenLastUsed[skill] = entry.daysPassedWhenLastUsed;
+			table.daysPassedSinceLastDecay[skill] = entry.daysPassedSinceLastDecay;
+			table.lastKnownXP[skill] = entry.lastKnownXP;
+			table.lastKnownLevel[skill] = entry.lastKnownLevel;
+			table.lastKnownLegendaryLevel[skill] = entry.lastKnownLegendaryLevel;
+			table.lastKnownHighestLevel[skill] = entry.lastKnownHighestLevel;
+			table.isDecaying[skill] = entry.isDecaying != 0;
+			loaded.set(skill);
+		}
+		return true;
+	}
+
+	/// Reads SkillUsage records of any version in the order they appear in a co-save.
+	///
+	/// Version 1 stored each skill in its own record, so the loader keeps track of which skill the next such record belongs to.
+	class SkillUsageLoader
+	{
+	public:
+		enum class Result
+		{
+			kLoaded,
+			/// Record doesn't contain any data, e.g. empty records that version 1 wrote before each skill.
+			kSkipped,
+			/// Version 1 record past the last skill.
+			kUnexpected,
+			/// Record is malformed. Skills that it was supposed to contain are reverted.
+			kFailed,
+			kUnsupported
+		};
+
+		explicit SkillUsageLoader(SkillUsageTable& table) :
+			table(table) {}
+
+		/// Reads the current record of given version and length.
+		template <typename Interface>
+		Result Load(Interface* a_interface, std::uint32_t version, std::uint32_t length)
+		{
+			switch (version) {
+			case 1:
+				{
+					// Version 1 opened every record twice, so each skill is preceded by an empty record.
+					if (length == 0) {
+						return Result::kSkipped;
+					}
+					if (nextLegacySkill >= skillCount) {
+						return Result::kUnexpected;
+					}
+					const auto skill = nextLegacySkill++;
+					if (!Read(a_interface, table[skill])) {
+						table[skill].Revert();
+						return Result::kFailed;
+					}
+					loaded.set(skill);
+					return Result::kLoaded;
+				}
+			case 2:
+				{
+					std::bitset<skillCount> recordLoaded;
+					if (!Read(a_interface, table, length, recordLoaded)) {
+						for (std::size_t skill = 0; skill < skillCount; ++skill) {
+							table[skill].Revert();
+						}
+						loaded.reset();
+						return Result::kFailed;
+					}
+					loaded |= recordLoaded;
+					return Result::kLoaded;
+				}
+			default:
+				return Result::kUnsupported;
+			}
+		}
+
+		/// Skill that the next version 1 record belongs to.
+		std::size_t GetNextLegacySkill() const { return nextLegacySkill; }
+
+		/// Skills that were read from the records so far.
+		const std::bitset<skillCount>& GetLoaded() const { return loaded; }
+
+	private:
+		SkillUsageTable&        table;
+		std::size_t             nextLegacySkill = 0;
+		std::bitset<skillCount> loaded;
+	};
+}
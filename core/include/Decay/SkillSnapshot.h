@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Decay/SkillState.h"
+
+namespace Decay
+{
+	/// SkillState that works on a copy of the skill's state.
+	///
+	/// The copy is taken once, so that an update which reads the same values over and over doesn't go back to their source each time.
+	/// Changes are only recorded, and it's up to the owner to write back the skills that were modified.
+	class SkillSnapshot final : public SkillState
+	{
+	public:
+		/// Takes a copy of the skill's state, forgetting any recorded changes.
+		void Capture(float a_level, const SkillProgress& a_progress, int a_legendaryLevel, int a_difficulty, const LevelingParams& a_leveling)
+		{
+			level = a_level;
+			progress = a_progress;
+			legendaryLevel = a_legendaryLevel;
+			difficulty = a_difficulty;
+			leveling = a_leveling;
+			levelDelta = 0.0f;
+			isProgressModified = false;
+		}
+
+		float GetLevel() const override { return level; }
+		void  ModLevel(float delta) override
+		{
+			level += delta;
+			levelDelta += delta;
+		}
+
+		SkillProgress GetProgress() const override { return progress; }
+		void          SetProgress(const SkillProgress& a_progress) override
+		{
+			progress = a_progress;
+			isProgressModified = true;
+		}
+
+		int GetLegendaryLevel() const override { return legendaryLevel; }
+		int GetDifficulty() const override { return difficulty; }
+
+		LevelingParams GetLeveling() const override { return leveling; }
+
+		/// Total change of the level since the capture, to be written back as a single modification.
+		float GetLevelDelta() const { return levelDelta; }
+
+		bool IsProgressModified() const { return isProgressModified; }
+
+	private:
+		float          level = 0.0f;
+		SkillProgress  progress;
+		int            legendaryLevel = 0;
+		int            difficulty = 0;
+		LevelingParams leveling;
+
+		float levelDelta = 0.0f;
+		bool  isProgressModified = false;
+	};
+
+	/// Clock that is stopped at the moment of a snapshot.
+	class SnapshotClock final : public Clock
+	{
+	public:
+		explicit SnapshotClock(float daysPassed = 0.0f) :
+			daysPassed(daysPassed)
+		{}
+
+		float GetDaysPassed() const override { return daysPassed; }
+
+	private:
+		float daysPassed;
+	};
+}
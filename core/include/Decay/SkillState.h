@@ -0,0 +1,59 @@
+#pragma once
+
+namespace Decay
+{
+	/// Progress of a skill towards the next level.
+	/// Mirrors the game's SkillData.
+	struct SkillProgress
+	{
+		/// Last level that Player has confirmed in Skills Menu.
+		/// Might be lower than the actual level of the skill, if Player has pending level ups.
+		float level = 0.0f;
+		float xp = 0.0f;
+		float levelThreshold = 0.0f;
+	};
+
+	/// Parameters of the skill's leveling formula:
+	/// threshold(level) = improveMult * (level - 1)^curve + improveOffset
+	struct LevelingParams
+	{
+		float improveMult = 0.0f;
+		float improveOffset = 0.0f;
+		float curve = 0.0f;
+	};
+
+	/// Access to the state of a single skill that SkillUsage tracks.
+	/// The plugin implements it on top of the Player, while tools can provide their own simulated state.
+	class SkillState
+	{
+	public:
+		virtual ~SkillState() = default;
+
+		/// Current level of the skill.
+		virtual float GetLevel() const = 0;
+
+		/// Changes current level of the skill by the given amount.
+		virtual void ModLevel(float delta) = 0;
+
+		virtual SkillProgress GetProgress() const = 0;
+		virtual void          SetProgress(const SkillProgress& progress) = 0;
+
+		/// Number of times the skill was made legendary.
+		virtual int GetLegendaryLevel() const = 0;
+
+		/// Current game difficulty, from 0 (Novice) to 5 (Legendary).
+		virtual int GetDifficulty() const = 0;
+
+		virtual LevelingParams GetLeveling() const = 0;
+	};
+
+	/// Source of in-game time.
+	class Clock
+	{
+	public:
+		virtual ~Clock() = default;
+
+		/// Number of in-game days passed since the game has started.
+		virtual float GetDaysPassed() const = 0;
+	};
+}
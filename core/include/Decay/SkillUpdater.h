@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Decay/DeadlineScheduler.h"
+#include "Decay/SkillUsage.h"
+#include <bitset>
+#include <cstddef>
+
+namespace Decay
+{
+	/// Schedules SkillUsage updates of all skills and runs them once they are due.
+	///
+	/// This is the part of skill tracking that doesn't depend on the game: the plugin and the tools only supply
+	/// states of the skills and the clock, and handle the results of each update in their own way.
+	class SkillUpdater
+	{
+	public:
+		using SkillSet = std::bitset<skillCount>;
+
+		explicit SkillUpdater(SkillUsageTable& usages) :
+			usages(usages)
+		{}
+
+		/// Hours between SkillUsage updates of decaying skills.
+		float trackingRate = 0.016f;  // once every in-game minute by default
+
+		UpdateMode mode = UpdateMode::kStep;
+
+		/// Skills that are currently decaying, as of their last update.
+		const SkillSet& GetDecaying() const { return decaying; }
+
+		/// Checks whether any of the skills is due at given time.
+		bool IsDue(float daysPassed) const { return scheduler.IsDue(daysPassed); }
+
+		/// Removes all skills that are due at given time from the schedule and returns them.
+		/// Skills are collected up front, so that skills re-scheduled during the update are not picked up again.
+		SkillSet PopDue(float daysPassed);
+
+		/// Updates given skills, scheduling their next updates and keeping track of the ones that are decaying.
+		/// getState(skill) supplies the SkillState of each skill, and onUpdated(skill, event) is called right after the skill is updated.
+		template <typename GetState, typename OnUpdated>
+		void Update(const SkillSet& skills, const Clock& clock, GetState&& getState, OnUpdated&& onUpdated)
+		{
+			for (std::size_t skill = 0; skill < skillCount; ++skill) {
+				if (!skills[skill]) {
+					continue;
+				}
+
+				auto&      state = getState(skill);
+				const auto event = Update(skill, state, clock);
+				onUpdated(skill, event);
+			}
+		}
+
+		/// Marks given skill as used at the current moment and schedules its next update.
+		/// Returns whether the skill was decaying until now.
+		bool SetUsed(std::size_t skill, SkillState&, const Clock&);
+
+		/// Schedules all skills to be updated as soon as possible.
+		void ResetSchedule();
+
+		/// Forgets which skills are decaying, e.g. when their usages are reverted.
+		void ResetDecaying() { decaying.reset(); }
+
+	private:
+		SkillUsageTable&  usages;
+		DeadlineScheduler scheduler{ skillCount };
+		SkillSet          decaying;
+
+		SkillEvent Update(std::size_t skill, SkillState&, const Clock&);
+
+		/// Schedules the next update of the skill based on its current state.
+		void Reschedule(std::size_t skill, const SkillState&, const Clock&);
+	};
+}
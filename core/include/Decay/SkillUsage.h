@@ -0,0 +1,232 @@
+#pragma once
+
+#include "Decay/DecayBatch.h"
+#include "Decay/DecayConfig.h"
+#include "Decay/LevelThresholds.h"
+#include "Decay/SkillState.h"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace Decay
+{
+	/// What happened to a skill during a single SkillUsage update.
+	enum class SkillEvent : std::uint8_t
+	{
+		kNone,
+		kUsed,
+		kStale,
+		kDecayed,
+		kLevelLost
+	};
+
+	/// How SkillUsage::Update() treats the time that passed since the previous update.
+	enum class UpdateMode : std::uint8_t
+	{
+		/// A single state transition per update, which happens at the moment of the update.
+		/// Accuracy depends on how often skills are updated.
+		kStep,
+
+		/// All transitions since the previous update are applied as of the moments they actually happened:
+		/// decay starts exactly when the grace period runs out and stops exactly at the decay cap.
+		/// Results don't depend on how often skills are updated, so they can be updated much less often.
+		kExact
+	};
+
+	class SkillUsageTable;
+	struct SkillUsageRecord;
+
+	/// Read-only view of the skill's entry in SkillUsageTable.
+	///
+	/// This is what a const SkillUsageTable hands out, so it only has the queries of SkillUsage.
+	/// Like SkillUsage, it is a lightweight handle that is meant to be passed around by value.
+	class ConstSkillUsage
+	{
+	public:
+		ConstSkillUsage(const SkillUsageTable* table, std::size_t skill) :
+			table(table), skill(skill)
+		{}
+
+		/// Checks whether this SkillUsage has received at least one SetUsed() call.
+		bool IsInitialized() const;
+
+		/// Checks whether skill has gained levels since the last time it was used.
+		/// XP gains are expected to be reported directly with SetUsed(), so this only catches level ups that bypass it (e.g. skill books or trainers).
+		bool WasUsed(const SkillState& state) const;
+
+		bool IsStale(const SkillState& state, const Clock& clock) const;
+
+		bool IsDecaying(const SkillState& state) const;
+
+		int GetDecayCapLevel(const SkillState& state) const;
+
+		/// Days passed when this SkillUsage needs to be updated next.
+		/// trackingRate is the number of hours between updates of a decaying skill.
+		float GetNextUpdateTime(const SkillState& state, const Clock& clock, float trackingRate) const;
+
+		/// Days passed when the grace period of the skill runs out, given its current state.
+		float GetGraceExpiry(const SkillState& state) const;
+
+		/// Days passed when the skill was last used.
+		float GetDaysPassedWhenLastUsed() const;
+
+		/// In-game days it takes the skill to decay a full level at its current level and decay rate.
+		/// Infinity if the skill doesn't decay at all.
+		float GetDaysPerLevel(const SkillState& state) const;
+
+		const DecayConfig& GetConfig() const;
+
+	protected:
+		const SkillUsageTable* table;
+		std::size_t            skill;
+
+		/// XP that the skill loses over the config's interval while decaying.
+		float GetDecayXPPerInterval(const SkillState& state) const;
+
+		int   GetStartingLevel() const;
+		int   GetDecayTargetLevel() const;
+		float GetDifficultyMult(const SkillState& state) const;
+
+		float GetGracePeriod(const SkillState& state) const;
+
+		float GetLegendaryMult(const SkillState& state) const;
+
+		int GetDifficulty(const SkillState& state) const;
+
+		/// Decay cap for the given skill level, used while the actual level is not yet updated.
+		int GetDecayCapLevel(const SkillState& state, float level) const;
+
+		float CalculateLevelThresholdXP(int level) const;
+	};
+
+	/// Tracks usage of a single skill and decays it when it is not used for a while.
+	///
+	/// SkillUsage is a lightweight handle to the skill's entry in SkillUsageTable, so it is meant to be passed around by value.
+	class SkillUsage : public ConstSkillUsage
+	{
+	public:
+		SkillUsage(SkillUsageTable* table, std::size_t skill) :
+			ConstSkillUsage(table, skill)
+		{}
+
+		/// Sets up the SkillUsage for the given config.
+		///
+		/// baselineLevel is the starting level of all skills in the game.
+		/// raceSkillBonus is the bonus that Player's race provides to this skill.
+		/// config.baselineLevelOffset must already be resolved to a non-negative value.
+		void Init(const DecayConfig& config, int baselineLevel, int raceSkillBonus);
+		void Revert();
+
+		/// Updates the starting level of all skills in the game.
+		void SetBaselineLevel(int level);
+
+		/// Makes sure that cached level thresholds match current leveling parameters of the skill.
+		void UpdateThresholds(const SkillState& state);
+
+		/// Advances the state of the skill:
+		/// marks it used if it was used since the last update, decays it if it is decaying, or marks it decaying once it becomes stale.
+		/// In UpdateMode::kExact a skill that became stale since the last update is also decayed for the time it was stale.
+		/// Returns the most significant event of the update.
+		SkillEvent Update(SkillState& state, const Clock& clock, UpdateMode mode = UpdateMode::kStep);
+
+		void SetUsed(const SkillState& state, const Clock& clock);
+
+		void MarkDecaying(const Clock& clock);
+		void Decay(SkillState& state, const Clock& clock, UpdateMode mode = UpdateMode::kStep);
+
+	private:
+		/// The table that ConstSkillUsage views. SkillUsage is only ever constructed from a mutable table, so it's safe to modify it.
+		SkillUsageTable& GetTable() const { return const_cast<SkillUsageTable&>(*table); }
+
+		/// Subtracts decayXPAmount, decreasing skill level as needed.
+		/// The resulting level change is applied to the state as a single modification.
+		/// Returns the skill level after decay.
+		float DecaySkill(SkillState& state, float& decayXPAmount, UpdateMode mode);
+
+		/// Marks the skill as decaying since the given moment.
+		void MarkDecaying(float daysPassed);
+
+		/// Resolves startingLevel and decayTargetLevel of the skill after its baseline level, race bonus or config has changed.
+		void ResolveLevels();
+
+		template <typename Interface>
+		friend bool Read(Interface*, SkillUsage);
+	};
+
+	/// Usage of all skills, stored as a structure of arrays.
+	///
+	/// Everything that an update of a skill reads or writes is packed into a compact block at the start of the table,
+	/// so that updating all skills touches only a few cache lines.
+	/// Of the skill's DecayConfig only the values that updates use are kept there, with the levels they depend on resolved in advance.
+	/// Level thresholds, of which each update reads a single value, and the configs themselves are kept in a separate cold part at the end.
+	class SkillUsageTable
+	{
+	public:
+		SkillUsageTable();
+
+		SkillUsage      operator[](std::size_t skill) { return { this, skill }; }
+		ConstSkillUsage operator[](std::size_t skill) const { return { this, skill }; }
+
+	private:
+		// ---- Hot ----
+
+		/// Days Passed when the skill was last used.
+		alignas(64) std::array<float, skillCount> daysPassedWhenLastUsed;
+		std::array<float, skillCount>             daysPassedSinceLastDecay;
+
+		std::array<int, skillCount>   lastKnownLevel;
+		std::array<float, skillCount> lastKnownXP;
+
+		std::array<int, skillCount> lastKnownLegendaryLevel;
+
+		/// Highest level achieved in each skill, used for relative decay cap when decayCap is negative.
+		std::array<int, skillCount> lastKnownHighestLevel;
+
+		std::array<bool, skillCount> isDecaying;
+
+		/// Level below which the skill never decays: baselineLevel + raceSkillBonus.
+		std::array<int, skillCount> startingLevel;
+
+		/// Level whose XP threshold the skill loses over decayInterval, see DecayConfig::baselineLevelOffset and DecayConfig::levelOffset.
+		std::array<int, skillCount> decayTargetLevel;
+
+		// Parameters of DecayConfig that updates read, copied out by SkillUsage::Init().
+
+		std::array<float, skillCount> decayInterval;
+		std::array<float, skillCount> decayDamping;
+		std::array<float, skillCount> minDaysPerLevel;
+		std::array<float, skillCount> maxDaysPerLevel;
+		std::array<float, skillCount> difficultyMult;
+		std::array<int, skillCount>   difficultyOverride;
+		std::array<float, skillCount> legendarySkillDamping;
+		std::array<float, skillCount> gracePeriod;
+		std::array<int, skillCount>   levelCap;
+
+		// ---- Cold ----
+
+		/// XP thresholds for all levels of each skill.
+		std::array<LevelThresholds, skillCount> thresholds;
+
+		std::array<DecayConfig, skillCount> decay;
+
+		/// Starting level of the skill.
+		std::array<int, skillCount> baselineLevel;
+
+		/// Bonus that Player's race provides to the skill.
+		/// Together with baselineLevel is used to calculate XP decay rate for the skill.
+		/// Also, used to prevent decaying below (baselineLevel + raceSkillBonus).
+		std::array<int, skillCount> raceSkillBonus;
+
+		friend class ConstSkillUsage;
+		friend class SkillUsage;
+
+		template <typename Interface>
+		friend bool Read(Interface*, SkillUsage);
+
+		friend std::array<SkillUsageRecord, skillCount> MakeSkillUsageRecords(const SkillUsageTable&);
+
+		template <typename Interface>
+		friend bool Read(Interface*, SkillUsageTable&, std::uint32_t, std::bitset<skillCount>&);
+	};
+}
@@ -0,0 +1,119 @@
+#include "Decay/DeadlineScheduler.h"
+#include <cassert>
+
+namespace Decay
+{
+	DeadlineScheduler::DeadlineScheduler(std::size_t capacity) :
+		deadlines(capacity, never),
+		positions(capacity, unscheduled)
+	{
+		heap.reserve(capacity);
+	}
+
+	void DeadlineScheduler::Schedule(Entry entry, float deadline)
+	{
+		assert(entry < GetCapacity());
+
+		if (!IsScheduled(entry)) {
+			deadlines[entry] = deadline;
+			heap.push_back(entry);
+			positions[entry] = heap.size() - 1;
+			SiftUp(heap.size() - 1);
+			return;
+		}
+
+		const float previous = deadlines[entry];
+		deadlines[entry] = deadline;
+		if (deadline < previous) {
+			SiftUp(positions[entry]);
+		} else if (deadline > previous) {
+			SiftDown(positions[entry]);
+		}
+	}
+
+	void DeadlineScheduler::Cancel(Entry entry)
+	{
+		assert(entry < GetCapacity());
+
+		if (IsScheduled(entry)) {
+			Remove(positions[entry]);
+		}
+	}
+
+	void DeadlineScheduler::Clear()
+	{
+		for (const auto entry : heap) {
+			positions[entry] = unscheduled;
+			deadlines[entry] = never;
+		}
+		heap.clear();
+	}
+
+	std::optional<DeadlineScheduler::Entry> DeadlineScheduler::PopDue(float now)
+	{
+		if (!IsDue(now)) {
+			return std::nullopt;
+		}
+
+		const Entry entry = heap.front();
+		Remove(0);
+		return entry;
+	}
+
+	void DeadlineScheduler::Remove(std::size_t position)
+	{
+		const Entry entry = heap[position];
+		const Entry last = heap.back();
+		heap.pop_back();
+
+		positions[entry] = unscheduled;
+		deadlines[entry] = never;
+
+		if (position < heap.size()) {
+			Place(position, last);
+			SiftUp(position);
+			SiftDown(positions[last]);
+		}
+	}
+
+	void DeadlineScheduler::SiftUp(std::size_t position)
+	{
+		const Entry entry = heap[position];
+		while (position > 0) {
+			const std::size_t parent = (position - 1) / 2;
+			if (!IsEarlier(entry, heap[parent])) {
+				break;
+			}
+			Place(position, heap[parent]);
+			position = parent;
+		}
+		Place(position, entry);
+	}
+
+	void DeadlineScheduler::SiftDown(std::size_t position)
+	{
+		const Entry       entry = heap[position];
+		const std::size_t size = heap.size();
+		while (true) {
+			std::size_t child = position * 2 + 1;
+			if (child >= size) {
+				break;
+			}
+			if (child + 1 < size && IsEarlier(heap[child + 1], heap[child])) {
+				++child;
+			}
+			if (!IsEarlier(heap[child], entry)) {
+				break;
+			}
+			Place(position, heap[child]);
+			position = child;
+		}
+		Place(position, entry);
+	}
+
+	void DeadlineScheduler::Place(std::size_t position, Entry entry)
+	{
+		heap[position] = entry;
+		positions[entry] = position;
+	}
+}
@@ -0,0 +1,177 @@
+#include "Decay/DecayKernel.h"
+#include "DecayKernelImpl.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#	define DECAY_KERNEL_X64
+#	if defined(_MSC_VER)
+#		include <immintrin.h>
+#		include <intrin.h>
+#	endif
+#endif
+
+namespace Decay
+{
+	namespace details
+	{
+		namespace
+		{
+			/// Lanes of width 1 that mirror operations of the SIMD instruction sets exactly.
+			struct ScalarLanes
+			{
+				using Float = float;
+				using Int = std::int32_t;
+
+				static constexpr std::size_t width = 1;
+
+				static Float Splat(float value) { return value; }
+				static Int   SplatInt(std::int32_t value) { return value; }
+
+				static Float Load(const float* data) { return *data; }
+				static void  Store(float* data, Float value) { *data = value; }
+				static Float LoadUnaligned(const float* data) { return *data; }
+				static void  StoreUnaligned(float* data, Float value) { *data = value; }
+
+				static Float Add(Float lhs, Float rhs) { return lhs + rhs; }
+				static Float Sub(Float lhs, Float rhs) { return lhs - rhs; }
+				static Float Mul(Float lhs, Float rhs) { return lhs * rhs; }
+				static Float Div(Float lhs, Float rhs) { return lhs / rhs; }
+				static Float Min(Float lhs, Float rhs) { return lhs < rhs ? lhs : rhs; }
+				static Float Max(Float lhs, Float rhs) { return lhs > rhs ? lhs : rhs; }
+				static Float Floor(Float value) { return std::floor(value); }
+
+				// Comparisons produce masks with all bits set, like SIMD comparisons do.
+				static Float Greater(Float lhs, Float rhs) { return AsFloat(lhs > rhs ? -1 : 0); }
+				static Float LessOrEqual(Float lhs, Float rhs) { return AsFloat(lhs <= rhs ? -1 : 0); }
+				static Float Select(Float mask, Float ifTrue, Float ifFalse) { return AsInt(mask) ? ifTrue : ifFalse; }
+
+				static Int Add(Int lhs, Int rhs) { return lhs + rhs; }
+				static Int Sub(Int lhs, Int rhs) { return lhs - rhs; }
+				static Int And(Int lhs, Int rhs) { return lhs & rhs; }
+				static Int Or(Int lhs, Int rhs) { return lhs | rhs; }
+				static Int ShiftLeft(Int value, int count) { return static_cast<Int>(static_cast<std::uint32_t>(value) << count); }
+				static Int ShiftRight(Int value, int count) { return static_cast<Int>(static_cast<std::uint32_t>(value) >> count); }
+
+				static Int   AsInt(Float value) { return std::bit_cast<Int>(value); }
+				static Float AsFloat(Int value) { return std::bit_cast<Float>(value); }
+				static Float ToFloat(Int value) { return static_cast<Float>(value); }
+				static Int   ToInt(Float value) { return static_cast<Int>(value); }
+			};
+		}
+
+		void CalculateDecayXPScalar(const DecayBatch& batch, float* decayXP)
+		{
+			CalculateDecayXP<ScalarLanes>(batch, decayXP);
+		}
+
+		void CalculatePowScalar(const float* x, const float* y, float* result, std::size_t count)
+		{
+			CalculatePow<ScalarLanes>(x, y, result, count);
+		}
+	}
+
+	DecayBatch::DecayBatch()
+	{
+		// Padding lanes evaluate to a level 2 threshold of 1 XP, so that they never produce NaNs or infinities.
+		for (auto* lanes : { hoursPassed, interval, difficultyMult, damping, legendaryMult, improveMult, curve, minDaysPerLevel, maxDaysPerLevel }) {
+			std::fill_n(lanes, size, 1.0f);
+		}
+		std::fill_n(targetLevel, size, 2.0f);
+		std::fill_n(improveOffset, size, 0.0f);
+	}
+
+	DecayKernelIsa GetSupportedDecayKernelIsa()
+	{
+#if defined(DECAY_KERNEL_X64)
+		static const DecayKernelIsa isa = [] {
+#	if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 1);
+			const bool hasSSE4 = info[2] & (1 << 19);
+			const bool hasOSXSAVE = info[2] & (1 << 27);
+			const bool hasAVX = info[2] & (1 << 28);
+
+			__cpuidex(info, 7, 0);
+			const bool hasAVX2 = info[1] & (1 << 5);
+
+			// The OS must also preserve YMM registers on context switches.
+			const bool hasYMM = hasOSXSAVE && hasAVX && (_xgetbv(0) & 0x6) == 0x6;
+#	else
+			__builtin_cpu_init();
+			const bool hasSSE4 = __builtin_cpu_supports("sse4.1");
+			const bool hasAVX2 = __builtin_cpu_supports("avx2");
+			const bool hasYMM = true;  // Checked by __builtin_cpu_supports.
+#	endif
+			if (hasAVX2 && hasYMM) {
+				return DecayKernelIsa::kAVX2;
+			}
+			if (hasSSE4) {
+				return DecayKernelIsa::kSSE4;
+			}
+			return DecayKernelIsa::kScalar;
+		}();
+		return isa;
+#else
+		return DecayKernelIsa::kScalar;
+#endif
+	}
+
+	const char* GetDecayKernelIsaName(DecayKernelIsa isa)
+	{
+		switch (isa) {
+		case DecayKernelIsa::kSSE4:
+			return "SSE4";
+		case DecayKernelIsa::kAVX2:
+			return "AVX2";
+		default:
+			return "Scalar";
+		}
+	}
+
+	void CalculateDecayXP(const DecayBatch& batch, float (&decayXP)[DecayBatch::size], DecayKernelIsa isa)
+	{
+		switch (isa) {
+#if defined(DECAY_KERNEL_X64)
+		case DecayKernelIsa::kAVX2:
+			return details::CalculateDecayXPAVX2(batch, decayXP);
+		case DecayKernelIsa::kSSE4:
+			return details::CalculateDecayXPSSE4(batch, decayXP);
+#endif
+		default:
+			return details::CalculateDecayXPScalar(batch, decayXP);
+		}
+	}
+
+	void CalculatePow(const float* x, const float* y, float* result, std::size_t count, DecayKernelIsa isa)
+	{
+		switch (isa) {
+#if defined(DECAY_KERNEL_X64)
+		case DecayKernelIsa::kAVX2:
+			return details::CalculatePowAVX2(x, y, result, count);
+		case DecayKernelIsa::kSSE4:
+			return details::CalculatePowSSE4(x, y, result, count);
+#endif
+		default:
+			return details::CalculatePowScalar(x, y, result, count);
+		}
+	}
+
+	void CalculateDecayXPReference(const DecayBatch& batch, float (&decayXP)[DecayBatch::size])
+	{
+		for (std::size_t i = 0; i < DecayBatch::size; ++i) {
+			float timeDelta = batch.hoursPassed[i] / batch.interval[i];
+
+			float mult = batch.difficultyMult[i] / (batch.damping[i] * batch.legendaryMult[i]);
+			float rawDecayXP = batch.improveMult[i] * std::pow(batch.targetLevel[i] - 1.0f, batch.curve[i]) + batch.improveOffset[i];
+			float fullDecayXP = rawDecayXP * mult;
+
+			float maxDecayXP = rawDecayXP * batch.minDaysPerLevel[i];
+			float minDecayXP = rawDecayXP * batch.maxDaysPerLevel[i];
+			float clampedDecayXP = std::max(minDecayXP, std::min(maxDecayXP, fullDecayXP));
+
+			decayXP[i] = clampedDecayXP * timeDelta;
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#include "DecayKernelImpl.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#	include <immintrin.h>
+
+namespace Decay::details
+{
+	namespace
+	{
+		struct AVX2Lanes
+		{
+			using Float = __m256;
+			using Int = __m256i;
+
+			static constexpr std::size_t width = 8;
+
+			static Float Splat(float value) { return _mm256_set1_ps(value); }
+			static Int   SplatInt(std::int32_t value) { return _mm256_set1_epi32(value); }
+
+			static Float Load(const float* data) { return _mm256_load_ps(data); }
+			static void  Store(float* data, Float value) { _mm256_store_ps(data, value); }
+			static Float LoadUnaligned(const float* data) { return _mm256_loadu_ps(data); }
+			static void  StoreUnaligned(float* data, Float value) { _mm256_storeu_ps(data, value); }
+
+			static Float Add(Float lhs, Float rhs) { return _mm256_add_ps(lhs, rhs); }
+			static Float Sub(Float lhs, Float rhs) { return _mm256_sub_ps(lhs, rhs); }
+			static Float Mul(Float lhs, Float rhs) { return _mm256_mul_ps(lhs, rhs); }
+			static Float Div(Float lhs, Float rhs) { return _mm256_div_ps(lhs, rhs); }
+			static Float Min(Float lhs, Float rhs) { return _mm256_min_ps(lhs, rhs); }
+			static Float Max(Float lhs, Float rhs) { return _mm256_max_ps(lhs, rhs); }
+			static Float Floor(Float value) { return _mm256_floor_ps(value); }
+
+			static Float Greater(Float lhs, Float rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_GT_OQ); }
+			static Float LessOrEqual(Float lhs, Float rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_LE_OQ); }
+			static Float Select(Float mask, Float ifTrue, Float ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+
+			static Int Add(Int lhs, Int rhs) { return _mm256_add_epi32(lhs, rhs); }
+			static Int Sub(Int lhs, Int rhs) { return _mm256_sub_epi32(lhs, rhs); }
+			static Int And(Int lhs, Int rhs) { return _mm256_and_si256(lhs, rhs); }
+			static Int Or(Int lhs, Int rhs) { return _mm256_or_si256(lhs, rhs); }
+			static Int ShiftLeft(Int value, int count) { return _mm256_sll_epi32(value, _mm_cvtsi32_si128(count)); }
+			static Int ShiftRight(Int value, int count) { return _mm256_srl_epi32(value, _mm_cvtsi32_si128(count)); }
+
+			static Int   AsInt(Float value) { return _mm256_castps_si256(value); }
+			static Float AsFloat(Int value) { return _mm256_castsi256_ps(value); }
+			static Float ToFloat(Int value) { return _mm256_cvtepi32_ps(value); }
+			static Int   ToInt(Float value) { return _mm256_cvttps_epi32(value); }
+		};
+	}
+
+	void CalculateDecayXPAVX2(const DecayBatch& batch, float* decayXP)
+	{
+		CalculateDecayXP<AVX2Lanes>(batch, decayXP);
+	}
+
+	void CalculatePowAVX2(const float* x, const float* y, float* result, std::size_t count)
+	{
+		CalculatePow<AVX2Lanes>(x, y, result, count);
+	}
+}
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+
+// Implementation of the decay kernel shared by all instruction sets.
+//
+// Each instruction set provides a Lanes type with a set of static functions over its vector types
+// and instantiates the templates below with it.
+// This header is included by translation units that are compiled with instruction set specific flags,
+// so it must not pull in any code that might be shared with the rest of the program,
+// which is why it only includes DecayBatch.h and not DecayKernel.h.
+
+#include "Decay/DecayBatch.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Decay::details
+{
+	void CalculateDecayXPScalar(const DecayBatch& batch, float* decayXP);
+	void CalculateDecayXPSSE4(const DecayBatch& batch, float* decayXP);
+	void CalculateDecayXPAVX2(const DecayBatch& batch, float* decayXP);
+
+	void CalculatePowScalar(const float* x, const float* y, float* result, std::size_t count);
+	void CalculatePowSSE4(const float* x, const float* y, float* result, std::size_t count);
+	void CalculatePowAVX2(const float* x, const float* y, float* result, std::size_t count);
+
+	/// log2(x) for positive normal x.
+	///
+	/// x = 2^e * m, where m is in [sqrt(0.5), sqrt(2)),
+	/// log2(m) = 2 / ln(2) * atanh(t) with t = (m - 1) / (m + 1), |t| <= 0.172,
+	/// atanh(t) is approximated by its series up to t^9, truncation error is below 1e-9.
+	template <typename L>
+	typename L::Float Log2(typename L::Float x)
+	{
+		using Float = typename L::Float;
+
+		const auto bits = L::AsInt(x);
+		auto       exponent = L::Sub(L::ShiftRight(bits, 23), L::SplatInt(127));
+		Float      mantissa = L::AsFloat(L::Or(L::And(bits, L::SplatInt(0x007FFFFF)), L::SplatInt(0x3F800000)));
+
+		const auto isLarge = L::Greater(mantissa, L::Splat(1.41421356f));
+		mantissa = L::Select(isLarge, L::Mul(mantissa, L::Splat(0.5f)), mantissa);
+		exponent = L::Sub(exponent, L::AsInt(isLarge));  // true lanes are all ones, i.e. -1.
+
+		const Float t = L::Div(L::Sub(mantissa, L::Splat(1.0f)), L::Add(mantissa, L::Splat(1.0f)));
+		const Float t2 = L::Mul(t, t);
+
+		Float poly = L::Splat(2.0f / 9.0f);
+		poly = L::Add(L::Mul(poly, t2), L::Splat(2.0f / 7.0f));
+		poly = L::Add(L::Mul(poly, t2), L::Splat(2.0f / 5.0f));
+		poly = L::Add(L::Mul(poly, t2), L::Splat(2.0f / 3.0f));
+		poly = L::Add(L::Mul(poly, t2), L::Splat(2.0f));
+		poly = L::Mul(L::Mul(poly, t), L::Splat(1.44269504f));  // 1 / ln(2)
+
+		return L::Add(L::ToFloat(exponent), poly);
+	}
+
+	/// 2^x for x in [-126, 127].
+	///
+	/// x = n + f, where n is the nearest integer and f is in [-0.5, 0.5],
+	/// 2^f is approximated by its Taylor series up to f^7, truncation error is below 5e-9.
+	template <typename L>
+	typename L::Float Exp2(typename L::Float x)
+	{
+		using Float = typename L::Float;
+
+		x = L::Min(L::Max(x, L::Splat(-126.0f)), L::Splat(127.0f));
+
+		const Float n = L::Floor(L::Add(x, L::Splat(0.5f)));
+		const Float f = L::Sub(x, n);
+
+		Float poly = L::Splat(1.5252734e-5f);   // ln(2)^7 / 7!
+		poly = L::Add(L::Mul(poly, f), L::Splat(1.5403530e-4f));  // ln(2)^6 / 6!
+		poly = L::Add(L::Mul(poly, f), L::Splat(1.3333558e-3f));  // ln(2)^5 / 5!
+		poly = L::Add(L::Mul(poly, f), L::Splat(9.6181291e-3f));  // ln(2)^4 / 4!
+		poly = L::Add(L::Mul(poly, f), L::Splat(5.5504109e-2f));  // ln(2)^3 / 3!
+		poly = L::Add(L::Mul(poly, f), L::Splat(2.4022651e-1f));  // ln(2)^2 / 2!
+		poly = L::Add(L::Mul(poly, f), L::Splat(6.9314718e-1f));  // ln(2)
+		poly = L::Add(L::Mul(poly, f), L::Splat(1.0f));
+
+		const auto scale = L::AsFloat(L::ShiftLeft(L::Add(L::ToInt(n), L::SplatInt(127)), 23));
+		return L::Mul(poly, scale);
+	}
+
+	/// x^y for non-negative x. 0^y is 0.
+	template <typename L>
+	typename L::Float Pow(typename L::Float x, typename L::Float y)
+	{
+		const auto isZero = L::LessOrEqual(x, L::Splat(0.0f));
+		const auto result = Exp2<L>(L::Mul(y, Log2<L>(L::Max(x, L::Splat(1.17549435e-38f)))));
+		return L::Select(isZero, L::Splat(0.0f), result);
+	}
+
+	template <typename L>
+	void CalculatePow(const float* x, const float* y, float* result, std::size_t count)
+	{
+		std::size_t i = 0;
+		for (; i + L::width <= count; i += L::width) {
+			L::StoreUnaligned(result + i, Pow<L>(L::LoadUnaligned(x + i), L::LoadUnaligned(y + i)));
+		}
+		for (; i < count; ++i) {
+			float tailX[L::width] = { x[i] };
+			float tailY[L::width] = { y[i] };
+			float tail[L::width];
+			L::StoreUnaligned(tail, Pow<L>(L::LoadUnaligned(tailX), L::LoadUnaligned(tailY)));
+			result[i] = tail[0];
+		}
+	}
+
+	/// Same formula as in SkillUsage::Decay(), with the same order of operations.
+	template <typename L>
+	void CalculateDecayXP(const DecayBatch& batch, float* decayXP)
+	{
+		for (std::size_t i = 0; i < DecayBatch::size; i += L::width) {
+			const auto timeDelta = L::Div(L::Load(batch.hoursPassed + i), L::Load(batch.interval + i));
+			const auto mult = L::Div(L::Load(batch.difficultyMult + i), L::Mul(L::Load(batch.damping + i), L::Load(batch.legendaryMult + i)));
+
+			const auto level = L::Sub(L::Load(batch.targetLevel + i), L::Splat(1.0f));
+			const auto rawDecayXP = L::Add(L::Mul(L::Load(batch.improveMult + i), Pow<L>(level, L::Load(batch.curve + i))), L::Load(batch.improveOffset + i));
+			const auto fullDecayXP = L::Mul(rawDecayXP, mult);
+
+			const auto maxDecayXP = L::Mul(rawDecayXP, L::Load(batch.minDaysPerLevel + i));
+			const auto minDecayXP = L::Mul(rawDecayXP, L::Load(batch.maxDaysPerLevel + i));
+			const auto clampedDecayXP = L::Max(minDecayXP, L::Min(maxDecayXP, fullDecayXP));
+
+			L::Store(decayXP + i, L::Mul(clampedDecayXP, timeDelta));
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#include "DecayKernelImpl.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#	include <immintrin.h>
+
+namespace Decay::details
+{
+	namespace
+	{
+		struct SSE4Lanes
+		{
+			using Float = __m128;
+			using Int = __m128i;
+
+			static constexpr std::size_t width = 4;
+
+			static Float Splat(float value) { return _mm_set1_ps(value); }
+			static Int   SplatInt(std::int32_t value) { return _mm_set1_epi32(value); }
+
+			static Float Load(const float* data) { return _mm_load_ps(data); }
+			static void  Store(float* data, Float value) { _mm_store_ps(data, value); }
+			static Float LoadUnaligned(const float* data) { return _mm_loadu_ps(data); }
+			static void  StoreUnaligned(float* data, Float value) { _mm_storeu_ps(data, value); }
+
+			static Float Add(Float lhs, Float rhs) { return _mm_add_ps(lhs, rhs); }
+			static Float Sub(Float lhs, Float rhs) { return _mm_sub_ps(lhs, rhs); }
+			static Float Mul(Float lhs, Float rhs) { return _mm_mul_ps(lhs, rhs); }
+			static Float Div(Float lhs, Float rhs) { return _mm_div_ps(lhs, rhs); }
+			static Float Min(Float lhs, Float rhs) { return _mm_min_ps(lhs, rhs); }
+			static Float Max(Float lhs, Float rhs) { return _mm_max_ps(lhs, rhs); }
+			static Float Floor(Float value) { return _mm_floor_ps(value); }
+
+			static Float Greater(Float lhs, Float rhs) { return _mm_cmpgt_ps(lhs, rhs); }
+			static Float LessOrEqual(Float lhs, Float rhs) { return _mm_cmple_ps(lhs, rhs); }
+			static Float Select(Float mask, Float ifTrue, Float ifFalse) { return _mm_blendv_ps(ifFalse, ifTrue, mask); }
+
+			static Int Add(Int lhs, Int rhs) { return _mm_add_epi32(lhs, rhs); }
+			static Int Sub(Int lhs, Int rhs) { return _mm_sub_epi32(lhs, rhs); }
+			static Int And(Int lhs, Int rhs) { return _mm_and_si128(lhs, rhs); }
+			static Int Or(Int lhs, Int rhs) { return _mm_or_si128(lhs, rhs); }
+			static Int ShiftLeft(Int value, int count) { return _mm_sll_epi32(value, _mm_cvtsi32_si128(count)); }
+			static Int ShiftRight(Int value, int count) { return _mm_srl_epi32(value, _mm_cvtsi32_si128(count)); }
+
+			static Int   AsInt(Float value) { return _mm_castps_si128(value); }
+			static Float AsFloat(Int value) { return _mm_castsi128_ps(value); }
+			static Float ToFloat(Int value) { return _mm_cvtepi32_ps(value); }
+			static Int   ToInt(Float value) { return _mm_cvttps_epi32(value); }
+		};
+	}
+
+	void CalculateDecayXPSSE4(const DecayBatch& batch, float* decayXP)
+	{
+		CalculateDecayXP<SSE4Lanes>(batch, decayXP);
+	}
+
+	void CalculatePowSSE4(const float* x, const float* y, float* result, std::size_t count)
+	{
+		CalculatePow<SSE4Lanes>(x, y, result, count);
+	}
+}
+#endif
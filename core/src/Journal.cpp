@@ -0,0 +1,120 @@
+#include "Decay/Journal.h"
+#include <cstring>
+#include <utility>
+
+namespace Decay
+{
+	bool JournalWriter::Open(const std::filesystem::path& path, std::int64_t startTime)
+	{
+		Close();
+
+		file.open(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			file.close();
+			return false;
+		}
+
+		JournalHeader header{};
+		header.recordSize = sizeof(JournalRecord);
+		header.skillCount = skillCount;
+		header.startTime = startTime;
+		if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header))) {
+			file.close();
+			return false;
+		}
+		return true;
+	}
+
+	void JournalWriter::Close()
+	{
+		if (IsOpen()) {
+			Flush();
+			file.close();
+		}
+		size = 0;
+	}
+
+	bool JournalWriter::Flush()
+	{
+		if (!IsOpen()) {
+			return false;
+		}
+
+		const auto count = std::exchange(size, 0);
+		if (!file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(count * sizeof(JournalRecord))) || !file.flush()) {
+			file.close();
+			return false;
+		}
+		return true;
+	}
+
+	std::string JournalReader::Open(std::span<const std::byte> journal)
+	{
+		records = {};
+		if (journal.size() < sizeof(JournalHeader)) {
+			return "not a Skill Decay journal";
+		}
+
+		std::memcpy(&header, journal.data(), sizeof(header));
+		if (header.signature != journalSignature) {
+			return "not a Skill Decay journal";
+		}
+		if (header.version != journalVersion || header.recordSize != sizeof(JournalRecord)) {
+			return "unsupported journal version " + std::to_string(header.version);
+		}
+		if (header.skillCount != skillCount) {
+			return "unexpected number of skills " + std::to_string(header.skillCount);
+		}
+
+		records = journal.subspan(sizeof(JournalHeader));
+		return {};
+	}
+
+	JournalRecord JournalReader::GetRecord(std::size_t index) const
+	{
+		JournalRecord record;
+		std::memcpy(static_cast<void*>(&record), records.data() + index * sizeof(JournalRecord), sizeof(JournalRecord));
+		return record;
+	}
+
+	void JournalState::Apply(const JournalRecord& record)
+	{
+		daysPassed = record.daysPassed;
+
+		switch (record.type) {
+		case JournalRecord::Type::kReset:
+			resetCount += 1;
+			for (auto& entry : skills) {
+				entry.isKnown = false;
+			}
+			break;
+		case JournalRecord::Type::kSkill:
+			{
+				if (record.skill >= skillCount) {
+					break;
+				}
+
+				auto&      entry = skills[record.skill];
+				const bool isDecayStep = record.event == SkillEvent::kDecayed || record.event == SkillEvent::kLevelLost;
+				if (isDecayStep) {
+					entry.decaySteps += 1;
+					if (entry.isKnown && record.level < entry.level) {
+						entry.levelsLost += entry.level - record.level;
+					}
+				}
+				if (record.event != SkillEvent::kNone) {
+					entry.lastEvent = record.event;
+					entry.daysPassedWhenLastEvent = record.daysPassed;
+				}
+
+				entry.isKnown = true;
+				entry.level = record.level;
+				entry.capLevel = record.capLevel;
+				entry.xp = record.xp;
+				break;
+			}
+		default:
+			break;
+		}
+	}
+}
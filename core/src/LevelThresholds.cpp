@@ -0,0 +1,33 @@
+#include "Decay/LevelThresholds.h"
+#include <cmath>
+
+namespace Decay
+{
+	bool LevelThresholds::Update(const LevelingParams& a_params)
+	{
+		if (isBuilt && params.improveMult == a_params.improveMult && params.improveOffset == a_params.improveOffset && params.curve == a_params.curve)
+			return false;
+
+		params = a_params;
+
+		for (int level = 0; level <= maxLevel; ++level) {
+			thresholds[level] = Calculate(level);
+		}
+		isBuilt = true;
+
+		return true;
+	}
+
+	float LevelThresholds::operator[](int level) const
+	{
+		if (level >= 0 && level <= maxLevel) {
+			return thresholds[level];
+		}
+		return Calculate(level);
+	}
+
+	float LevelThresholds::Calculate(int level) const
+	{
+		return params.improveMult * std::pow(level - 1.0f, params.curve) + params.improveOffset;
+	}
+}
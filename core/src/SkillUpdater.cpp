@@ -0,0 +1,44 @@
+#include "Decay/SkillUpdater.h"
+
+namespace Decay
+{
+	SkillUpdater::SkillSet SkillUpdater::PopDue(float daysPassed)
+	{
+		SkillSet due;
+		while (const auto entry = scheduler.PopDue(daysPassed)) {
+			due.set(*entry);
+		}
+		return due;
+	}
+
+	bool SkillUpdater::SetUsed(std::size_t skill, SkillState& state, const Clock& clock)
+	{
+		usages[skill].SetUsed(state, clock);
+		Reschedule(skill, state, clock);
+
+		const bool wasDecaying = decaying.test(skill);
+		decaying.reset(skill);
+		return wasDecaying;
+	}
+
+	void SkillUpdater::ResetSchedule()
+	{
+		for (std::size_t skill = 0; skill < skillCount; ++skill) {
+			scheduler.Schedule(static_cast<DeadlineScheduler::Entry>(skill), 0.0f);
+		}
+	}
+
+	SkillEvent SkillUpdater::Update(std::size_t skill, SkillState& state, const Clock& clock)
+	{
+		auto       usage = usages[skill];
+		const auto event = usage.Update(state, clock, mode);
+		Reschedule(skill, state, clock);
+		decaying.set(skill, usage.IsDecaying(state));
+		return event;
+	}
+
+	void SkillUpdater::Reschedule(std::size_t skill, const SkillState& state, const Clock& clock)
+	{
+		scheduler.Schedule(static_cast<DeadlineScheduler::Entry>(skill), usages[skill].GetNextUpdateTime(state, clock, trackingRate));
+	}
+}
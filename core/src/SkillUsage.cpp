@@ -0,0 +1,390 @@
+#include "Decay/SkillUsage.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace Decay
+{
+	SkillUsageTable::SkillUsageTable()
+	{
+		daysPassedWhenLastUsed.fill(0);
+		daysPassedSinceLastDecay.fill(0);
+		lastKnownLevel.fill(-1);
+		lastKnownXP.fill(-1);
+		lastKnownLegendaryLevel.fill(-1);
+		lastKnownHighestLevel.fill(-1);
+		isDecaying.fill(false);
+		for (std::size_t skill = 0; skill < skillCount; ++skill) {
+			(*this)[skill].Init({}, 15, 0);
+		}
+	}
+
+	void SkillUsage::Init(const DecayConfig& config, int a_baselineLevel, int a_raceSkillBonus)
+	{
+		GetTable().decay[skill] = config;
+		GetTable().baselineLevel[skill] = a_baselineLevel;
+		GetTable().raceSkillBonus[skill] = a_raceSkillBonus;
+
+		GetTable().decayInterval[skill] = config.interval;
+		GetTable().decayDamping[skill] = config.damping;
+		GetTable().minDaysPerLevel[skill] = config.minDaysPerLevel;
+		GetTable().maxDaysPerLevel[skill] = config.maxDaysPerLevel;
+		GetTable().difficultyMult[skill] = config.difficultyMult;
+		GetTable().difficultyOverride[skill] = config.difficultyOverride;
+		GetTable().legendarySkillDamping[skill] = config.legendarySkillDamping;
+		GetTable().gracePeriod[skill] = config.gracePeriod;
+		GetTable().levelCap[skill] = config.levelCap;
+		ResolveLevels();
+	}
+
+	void SkillUsage::Revert()
+	{
+		GetTable().daysPassedWhenLastUsed[skill] = 0;
+		GetTable().lastKnownLevel[skill] = -1;
+		GetTable().lastKnownXP[skill] = -1;
+		GetTable().isDecaying[skill] = false;
+		GetTable().daysPassedSinceLastDecay[skill] = 0;
+	}
+
+	void SkillUsage::SetBaselineLevel(int level)
+	{
+		GetTable().baselineLevel[skill] = level;
+		ResolveLevels();
+	}
+
+	void SkillUsage::ResolveLevels()
+	{
+		const auto& decay = table->decay[skill];
+		const int   baselineLevel = table->baselineLevel[skill];
+		const int   raceSkillBonus = table->raceSkillBonus[skill];
+
+		GetTable().startingLevel[skill] = baselineLevel + raceSkillBonus;
+		// Level 2 is the smallest we can go to avoid Decay XP equaling zero.
+		GetTable().decayTargetLevel[skill] = std::max(2, baselineLevel + decay.baselineLevelOffset - raceSkillBonus - decay.levelOffset);
+	}
+
+	float ConstSkillUsage::GetDaysPassedWhenLastUsed() const
+	{
+		return table->daysPassedWhenLastUsed[skill];
+	}
+
+	const DecayConfig& ConstSkillUsage::GetConfig() const
+	{
+		return table->decay[skill];
+	}
+
+	void SkillUsage::UpdateThresholds(const SkillState& state)
+	{
+		GetTable().thresholds[skill].Update(state.GetLeveling());
+	}
+
+	SkillEvent SkillUsage::Update(SkillState& state, const Clock& clock, UpdateMode mode)
+	{
+		if (!IsInitialized() || WasUsed(state)) {
+			SetUsed(state, clock);
+			return SkillEvent::kUsed;
+		}
+
+		if (mode == UpdateMode::kExact) {
+			auto event = SkillEvent::kNone;
+
+			// Level doesn't change during the grace period, so its length is the same as it was all this time.
+			if (IsStale(state, clock)) {
+				MarkDecaying(std::min(GetGraceExpiry(state), clock.GetDaysPassed()));
+				event = SkillEvent::kStale;
+			}
+
+			// Decay rate doesn't depend on the current level, so decay accumulated over any interval is linear in time,
+			// and DecaySkill() stops where step updates would have stopped once the skill reaches its decay cap.
+			if (IsDecaying(state)) {
+				const float level = state.GetLevel();
+				Decay(state, clock, mode);
+				event = state.GetLevel() < level ? SkillEvent::kLevelLost : SkillEvent::kDecayed;
+			}
+
+			return event;
+		}
+
+		if (IsDecaying(state)) {
+			const float level = state.GetLevel();
+			Decay(state, clock);
+			return state.GetLevel() < level ? SkillEvent::kLevelLost : SkillEvent::kDecayed;
+		}
+
+		if (IsStale(state, clock)) {
+			MarkDecaying(clock);
+			return SkillEvent::kStale;
+		}
+
+		return SkillEvent::kNone;
+	}
+
+	bool ConstSkillUsage::IsInitialized() const
+	{
+		return table->lastKnownLevel[skill] >= 0 && table->lastKnownXP[skill] >= 0;
+	}
+
+	bool ConstSkillUsage::WasUsed(const SkillState& state) const
+	{
+		return state.GetLevel() > table->lastKnownLevel[skill];
+	}
+
+	void SkillUsage::SetUsed(const SkillState& state, const Clock& clock)
+	{
+		GetTable().lastKnownLevel[skill] = state.GetLevel();
+		GetTable().lastKnownXP[skill] = state.GetProgress().xp;
+		int legLevel = state.GetLegendaryLevel();
+		if (legLevel > table->lastKnownLegendaryLevel[skill]) {
+			GetTable().lastKnownHighestLevel[skill] = GetStartingLevel();
+		} else {
+			GetTable().lastKnownHighestLevel[skill] = std::max(table->lastKnownHighestLevel[skill], table->lastKnownLevel[skill]);
+		}
+		GetTable().lastKnownLegendaryLevel[skill] = legLevel;
+
+		GetTable().daysPassedWhenLastUsed[skill] = clock.GetDaysPassed();
+		GetTable().isDecaying[skill] = false;
+	}
+
+	bool ConstSkillUsage::IsStale(const SkillState& state, const Clock& clock) const
+	{
+		// If already decaying, no need to check further
+		if (table->isDecaying[skill])
+			return false;
+
+		auto hoursPassed = (clock.GetDaysPassed() - table->daysPassedWhenLastUsed[skill]) * 24.0f;
+		return hoursPassed >= GetGracePeriod(state);
+	}
+
+	void SkillUsage::MarkDecaying(const Clock& clock)
+	{
+		MarkDecaying(clock.GetDaysPassed());
+	}
+
+	void SkillUsage::MarkDecaying(float daysPassed)
+	{
+		GetTable().isDecaying[skill] = true;
+		GetTable().daysPassedSinceLastDecay[skill] = daysPassed;
+	}
+
+	bool ConstSkillUsage::IsDecaying(const SkillState& state) const
+	{
+		return table->isDecaying[skill] && state.GetLevel() > GetDecayCapLevel(state);  // If it can't decay any further, ignore the isDecaying flag.
+	}
+
+	void SkillUsage::Decay(SkillState& state, const Clock& clock, UpdateMode mode)
+	{
+		assert(table->isDecaying[skill]);
+
+		UpdateThresholds(state);
+
+		const float daysPassed = clock.GetDaysPassed();
+		const auto  hoursPassed = (daysPassed - table->daysPassedSinceLastDecay[skill]) * 24.0f;
+
+		float timeDelta = hoursPassed / table->decayInterval[skill];
+
+		float decayXP = GetDecayXPPerInterval(state) * timeDelta;
+
+		GetTable().lastKnownLevel[skill] = DecaySkill(state, decayXP, mode);
+		GetTable().lastKnownXP[skill] = state.GetProgress().xp;
+		GetTable().daysPassedSinceLastDecay[skill] = daysPassed;
+	}
+
+	float ConstSkillUsage::GetDecayXPPerInterval(const SkillState& state) const
+	{
+		float legendaryDamping = GetLegendaryMult(state);
+
+		float mult = GetDifficultyMult(state) / (table->decayDamping[skill] * legendaryDamping);
+		float rawDecayXP = CalculateLevelThresholdXP(GetDecayTargetLevel());
+		float fullDecayXP = rawDecayXP * mult;
+
+		// We calculate max XP that can be decayed, so that the decay rate won't exeed minDaysPerLevel (e.g. with minDaysPerLevel = 1, it would take at least 1 day to decay 1 level).
+		float maxDecayXP = rawDecayXP * table->minDaysPerLevel[skill];
+		// Similarly, we calculate min XP, so that the decay rate won't take ages to decay on higher levels.
+		float minDecayXP = rawDecayXP * table->maxDaysPerLevel[skill];
+		return std::max(minDecayXP, std::min(maxDecayXP, fullDecayXP));
+	}
+
+	float ConstSkillUsage::GetDaysPerLevel(const SkillState& state) const
+	{
+		const float xpPerDay = GetDecayXPPerInterval(state) * 24.0f / table->decayInterval[skill];
+		if (!(xpPerDay > 0.0f)) {
+			return std::numeric_limits<float>::infinity();
+		}
+		return CalculateLevelThresholdXP(static_cast<int>(state.GetLevel())) / xpPerDay;
+	}
+
+	float ConstSkillUsage::GetNextUpdateTime(const SkillState& state, const Clock& clock, float trackingRate) const
+	{
+		// Grace periods and decay caps depend on difficulty and legendary levels, which might change at any time.
+		// We re-evaluate such skills at least once per day to pick up those changes, as well as level ups that bypass UseSkill.
+		constexpr float maxUpdateDelay = 1.0f;
+
+		const float daysPassed = clock.GetDaysPassed();
+		const float nextTick = daysPassed + trackingRate / 24.0f;
+
+		if (!IsInitialized()) {
+			return daysPassed;
+		}
+
+		if (table->isDecaying[skill]) {
+			return IsDecaying(state) ? nextTick : daysPassed + maxUpdateDelay;
+		}
+
+		// Make sure that we don't end up re-scheduling the same moment over and over due to rounding of the grace period.
+		return std::max(nextTick, std::min(GetGraceExpiry(state), daysPassed + maxUpdateDelay));
+	}
+
+	float ConstSkillUsage::GetGraceExpiry(const SkillState& state) const
+	{
+		return table->daysPassedWhenLastUsed[skill] + GetGracePeriod(state) / 24.0f;
+	}
+
+	float SkillUsage::DecaySkill(SkillState& state, float& decayXPAmount, UpdateMode mode)
+	{
+		const float initialLevel = state.GetLevel();
+		float       level = initialLevel;
+		auto        progress = state.GetProgress();
+
+		// Walk down the levels locally and only touch the skill level once at the end,
+		// so that large decays (e.g. after a long sleep or a jail sentence) don't fire a burst of level changes.
+		while (decayXPAmount > 0.0f) {
+			if (progress.xp >= decayXPAmount) {
+				progress.xp -= decayXPAmount;
+				decayXPAmount = 0.0f;
+			} else if (level <= GetDecayCapLevel(state, level)) {
+				// We can't decay any further, so just reset XP.
+				progress.xp = 0.0f;
+				decayXPAmount = 0.0f;
+			} else {
+				decayXPAmount -= progress.xp;
+				const float threshold = CalculateLevelThresholdXP(static_cast<int>(level));
+				progress.xp = std::max(0.0f, threshold - 1);  // -1 to be safe, so that we won't end up in invalid state where xp == levelThreshold.
+				progress.levelThreshold = threshold;
+				// progress.level is only updated after player confirms level up (in Skills Menu).
+				// Before that, progress.level will remain at the last confirmed level, even if actual level is further.
+				if (level == progress.level) {
+					progress.level -= 1;
+				}
+				level -= 1;
+
+				// Step updates stop decaying as soon as the skill drops to its cap, so the rest of the interval must not drain its XP.
+				if (mode == UpdateMode::kExact && level <= GetDecayCapLevel(state, level)) {
+					decayXPAmount = 0.0f;
+				}
+			}
+		}
+
+		state.SetProgress(progress);
+		if (level != initialLevel) {
+			state.ModLevel(level - initialLevel);
+		}
+
+		return level;
+	}
+
+	inline int ConstSkillUsage::GetStartingLevel() const
+	{
+		return table->startingLevel[skill];
+	}
+
+	inline int ConstSkillUsage::GetDecayTargetLevel() const
+	{
+		return table->decayTargetLevel[skill];
+	}
+
+	inline float ConstSkillUsage::GetDifficultyMult(const SkillState& state) const
+	{
+		if (std::signbit(table->difficultyMult[skill])) {
+			constexpr float difficultyMults[] = {
+				1.0f,   // Novice
+				1.25f,  // Apprentice
+				1.5f,   // Adept
+				1.75f,  // Expert
+				2.0f,   // Master
+				3.0f    // Legendary
+			};
+			return difficultyMults[GetDifficulty(state)];
+		} else {
+			return table->difficultyMult[skill];
+		}
+	}
+
+	float ConstSkillUsage::GetGracePeriod(const SkillState& state) const
+	{
+		if (std::signbit(table->gracePeriod[skill])) {
+			float level = state.GetLevel();
+			float target = GetDecayTargetLevel();
+
+			float ratio = target < level ? 1.0f : level / target;
+
+			constexpr float difficultyMults[] = {
+				3.0f,   // Novice
+				2.0f,   // Apprentice
+				1.75f,  // Adept
+				1.5f,   // Expert
+				1.25f,  // Master
+				1.0f    // Legendary
+			};
+
+			auto diffMult = difficultyMults[GetDifficulty(state)];
+
+			auto gracePeriodBase = ratio * diffMult * GetLegendaryMult(state);
+
+			auto days = std::pow(std::max(1.0f, gracePeriodBase), 0.75f);
+
+			return std::max(1.0f, days) * 24.0f * GetLegendaryMult(state);
+		} else {
+			return table->gracePeriod[skill];
+		}
+	}
+
+	float ConstSkillUsage::GetLegendaryMult(const SkillState& state) const
+	{
+		return std::max(1.0f, 1 + (table->legendarySkillDamping[skill] - 1) * state.GetLegendaryLevel());
+	}
+
+	int ConstSkillUsage::GetDifficulty(const SkillState& state) const
+	{
+		if (table->difficultyOverride[skill] >= 0) {
+			return table->difficultyOverride[skill];
+		} else {
+			return state.GetDifficulty();
+		}
+	}
+
+	int ConstSkillUsage::GetDecayCapLevel(const SkillState& state) const
+	{
+		return GetDecayCapLevel(state, state.GetLevel());
+	}
+
+	int ConstSkillUsage::GetDecayCapLevel(const SkillState& state, float level) const
+	{
+		int effectiveLevelCap = table->levelCap[skill];
+
+		if (effectiveLevelCap == 0) {
+			constexpr int difficultyCaps[] = {
+				-5,   // Novice
+				-10,  // Apprentice
+				-15,  // Adept
+				-30,  // Expert
+				-40,  // Master
+				0     // Legendary
+			};
+			effectiveLevelCap = difficultyCaps[GetDifficulty(state)];
+		}
+
+		if (effectiveLevelCap > 0) {
+			return level >= effectiveLevelCap ? effectiveLevelCap : GetStartingLevel();
+		} else if (effectiveLevelCap < 0) {
+			return std::max(GetStartingLevel(), table->lastKnownHighestLevel[skill] + effectiveLevelCap);
+		} else {
+			return GetStartingLevel();
+		}
+	}
+
+	inline float ConstSkillUsage::CalculateLevelThresholdXP(int level) const
+	{
+		return table->thresholds[skill][level];
+	}
+}
@@ -0,0 +1,154 @@
+#include "Decay/DeadlineScheduler.h"
+#include "Tests.h"
+#include <iterator>
+#include <vector>
+
+using namespace Decay;
+
+namespace
+{
+	/// Pops all entries that are due at given time.
+	std::vector<DeadlineScheduler::Entry> PopAllDue(DeadlineScheduler& scheduler, float now)
+	{
+		std::vector<DeadlineScheduler::Entry> entries;
+		while (const auto entry = scheduler.PopDue(now)) {
+			entries.push_back(*entry);
+		}
+		return entries;
+	}
+
+	void TestEmpty()
+	{
+		DeadlineScheduler scheduler(4);
+		CHECK(scheduler.GetCapacity() == 4);
+		CHECK(scheduler.GetSize() == 0);
+		CHECK(scheduler.GetNextDeadline() == DeadlineScheduler::never);
+		CHECK(!scheduler.IsDue(0.0f));
+		CHECK(!scheduler.IsDue(1e30f));
+		CHECK(!scheduler.PopDue(1e30f));
+		CHECK(!scheduler.IsScheduled(0));
+		CHECK(scheduler.GetDeadline(0) == DeadlineScheduler::never);
+	}
+
+	void TestSchedule()
+	{
+		DeadlineScheduler scheduler(4);
+		scheduler.Schedule(2, 5.0f);
+		scheduler.Schedule(0, 3.0f);
+
+		CHECK(scheduler.GetSize() == 2);
+		CHECK(scheduler.IsScheduled(0) && scheduler.IsScheduled(2));
+		CHECK(!scheduler.IsScheduled(1));
+		CHECK(scheduler.GetDeadline(2) == 5.0f);
+		CHECK(scheduler.GetNextDeadline() == 3.0f);
+		CHECK(!scheduler.IsDue(2.9f));
+		CHECK(scheduler.IsDue(3.0f));
+	}
+
+	void TestReschedule()
+	{
+		DeadlineScheduler scheduler(4);
+		scheduler.Schedule(0, 1.0f);
+		scheduler.Schedule(1, 2.0f);
+		scheduler.Schedule(2, 3.0f);
+
+		// Later deadline moves the entry down the heap.
+		scheduler.Schedule(0, 4.0f);
+		CHECK(scheduler.GetSize() == 3);
+		CHECK(scheduler.GetDeadline(0) == 4.0f);
+		CHECK(scheduler.GetNextDeadline() == 2.0f);
+
+		// Earlier deadline moves it back up.
+		scheduler.Schedule(2, 0.5f);
+		CHECK(scheduler.GetSize() == 3);
+		CHECK(scheduler.GetNextDeadline() == 0.5f);
+
+		CHECK((PopAllDue(scheduler, 10.0f) == std::vector<DeadlineScheduler::Entry>{ 2, 1, 0 }));
+	}
+
+	void TestCancel()
+	{
+		DeadlineScheduler scheduler(4);
+		scheduler.Schedule(0, 1.0f);
+		scheduler.Schedule(1, 2.0f);
+		scheduler.Schedule(2, 3.0f);
+
+		scheduler.Cancel(0);
+		CHECK(!scheduler.IsScheduled(0));
+		CHECK(scheduler.GetSize() == 2);
+		CHECK(scheduler.GetNextDeadline() == 2.0f);
+
+		// Cancelling an entry that is not scheduled does nothing.
+		scheduler.Cancel(0);
+		scheduler.Cancel(3);
+		CHECK(scheduler.GetSize() == 2);
+
+		CHECK((PopAllDue(scheduler, 10.0f) == std::vector<DeadlineScheduler::Entry>{ 1, 2 }));
+	}
+
+	void TestPopDueOrder()
+	{
+		DeadlineScheduler scheduler(8);
+		const float       deadlines[] = { 7.0f, 3.0f, 5.0f, 1.0f, 6.0f, 2.0f, 4.0f, 0.0f };
+		for (DeadlineScheduler::Entry entry = 0; entry < std::size(deadlines); ++entry) {
+			scheduler.Schedule(entry, deadlines[entry]);
+		}
+
+		// Only entries that are due are popped, earliest first.
+		CHECK((PopAllDue(scheduler, 3.0f) == std::vector<DeadlineScheduler::Entry>{ 7, 3, 5, 1 }));
+		CHECK(scheduler.GetSize() == 4);
+		CHECK(scheduler.GetNextDeadline() == 4.0f);
+		CHECK((PopAllDue(scheduler, 10.0f) == std::vector<DeadlineScheduler::Entry>{ 6, 2, 4, 0 }));
+		CHECK(scheduler.GetSize() == 0);
+	}
+
+	void TestPopDueEqualDeadlines()
+	{
+		DeadlineScheduler scheduler(6);
+		for (DeadlineScheduler::Entry entry = 0; entry < 6; ++entry) {
+			scheduler.Schedule(entry, entry % 2 == 0 ? 1.0f : 2.0f);
+		}
+
+		// Entries with equal deadlines may come in any order, but all of them before any later deadline.
+		auto popped = PopAllDue(scheduler, 1.0f);
+		CHECK(popped.size() == 3);
+		for (const auto entry : popped) {
+			CHECK(entry % 2 == 0);
+		}
+
+		popped = PopAllDue(scheduler, 2.0f);
+		CHECK(popped.size() == 3);
+		for (const auto entry : popped) {
+			CHECK(entry % 2 == 1);
+			CHECK(!scheduler.IsScheduled(entry));
+		}
+	}
+
+	void TestClear()
+	{
+		DeadlineScheduler scheduler(4);
+		scheduler.Schedule(0, 1.0f);
+		scheduler.Schedule(3, 2.0f);
+
+		scheduler.Clear();
+		CHECK(scheduler.GetSize() == 0);
+		CHECK(!scheduler.IsScheduled(0) && !scheduler.IsScheduled(3));
+		CHECK(!scheduler.IsDue(1e30f));
+
+		// Scheduler is fully usable after being cleared.
+		scheduler.Schedule(3, 5.0f);
+		CHECK(scheduler.GetNextDeadline() == 5.0f);
+		CHECK((PopAllDue(scheduler, 5.0f) == std::vector<DeadlineScheduler::Entry>{ 3 }));
+	}
+}
+
+void RunDeadlineSchedulerTests()
+{
+	TestEmpty();
+	TestSchedule();
+	TestReschedule();
+	TestCancel();
+	TestPopDueOrder();
+	TestPopDueEqualDeadlines();
+	TestClear();
+}
@@ -0,0 +1,136 @@
+#include "Decay/DecayConfig.h"
+#include "Decay/DecayKernel.h"
+#include "Tests.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace Decay;
+
+namespace
+{
+	/// Scalar kernel and every instruction set that the CPU supports.
+	std::vector<DecayKernelIsa> GetSupportedIsas()
+	{
+		std::vector<DecayKernelIsa> isas = { DecayKernelIsa::kScalar };
+		const auto                  best = GetSupportedDecayKernelIsa();
+		if (best >= DecayKernelIsa::kSSE4) {
+			isas.push_back(DecayKernelIsa::kSSE4);
+		}
+		if (best >= DecayKernelIsa::kAVX2) {
+			isas.push_back(DecayKernelIsa::kAVX2);
+		}
+		return isas;
+	}
+
+	/// pow() stays within the documented error over the documented range, and all instruction sets agree bit for bit.
+	void TestPow()
+	{
+		std::vector<float> x, y;
+		for (float base = 1.0f; base <= 254.0f; base += 0.25f) {
+			for (float exponent = 0.5f; exponent <= 4.0f; exponent += 0.01f) {
+				x.push_back(base);
+				y.push_back(exponent);
+			}
+		}
+
+		std::vector<float> scalar(x.size());
+		CalculatePow(x.data(), y.data(), scalar.data(), x.size(), DecayKernelIsa::kScalar);
+
+		for (const auto isa : GetSupportedIsas()) {
+			std::vector<float> result(x.size());
+			CalculatePow(x.data(), y.data(), result.data(), x.size(), isa);
+
+			double      maxError = 0;
+			std::size_t mismatches = 0;
+			for (std::size_t i = 0; i < x.size(); ++i) {
+				const double exact = std::pow(static_cast<double>(x[i]), static_cast<double>(y[i]));
+				maxError = std::max(maxError, std::abs(result[i] - exact) / exact);
+				mismatches += result[i] != scalar[i];
+			}
+
+			std::printf("pow/%s: max relative error %.3g\n", GetDecayKernelIsaName(isa), maxError);
+			CHECK(maxError <= decayKernelPowError);
+			CHECK(mismatches == 0);
+		}
+	}
+
+	/// 0^y is 0 rather than whatever the approximation of log2(0) would produce.
+	void TestPowOfZero()
+	{
+		for (const auto isa : GetSupportedIsas()) {
+			const float x[] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+			const float y[] = { 0.5f, 1.0f, 1.5f, 2.0f, 2.5f, 3.0f, 3.5f, 4.0f, 1.95f };
+			float       result[std::size(x)];
+			CalculatePow(x, y, result, std::size(x), isa);
+			CHECK(std::all_of(std::begin(result), std::end(result), [](float value) { return value == 0.0f; }));
+		}
+	}
+
+	/// Fills the batch with random, but valid parameters of all skills.
+	void FillBatch(DecayBatch& batch, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> anyHours(0.016f, 30.0f * 24.0f);
+		std::uniform_int_distribution<>       anyLevel(2, 40);
+		std::uniform_int_distribution<>       anyLegendary(0, 10);
+		std::uniform_int_distribution<>       anyDifficulty(0, 5);
+
+		constexpr float difficultyMults[] = { 1.0f, 1.25f, 1.5f, 1.75f, 2.0f, 3.0f };
+
+		for (std::size_t skill = 0; skill < skillCount; ++skill) {
+			const DecayConfig config;
+			batch.hoursPassed[skill] = anyHours(random);
+			batch.interval[skill] = config.interval;
+			batch.difficultyMult[skill] = difficultyMults[anyDifficulty(random)];
+			batch.damping[skill] = config.damping;
+			batch.legendaryMult[skill] = std::max(1.0f, 1 + (config.legendarySkillDamping - 1) * anyLegendary(random));
+			batch.targetLevel[skill] = static_cast<float>(anyLevel(random));
+			batch.improveMult[skill] = 1.0f;
+			batch.improveOffset[skill] = 0.0f;
+			batch.curve[skill] = 1.95f;
+			batch.minDaysPerLevel[skill] = config.minDaysPerLevel;
+			batch.maxDaysPerLevel[skill] = config.maxDaysPerLevel;
+		}
+	}
+
+	/// Decay XP of every instruction set matches the scalar reference up to the error of pow().
+	void TestDecayXP()
+	{
+		// Besides the pow error, both results are rounded a few more times.
+		constexpr double bound = decayKernelPowError + 1e-6;
+
+		std::mt19937 random(42);
+		for (const auto isa : GetSupportedIsas()) {
+			double maxError = 0;
+			bool   isFinite = true;
+			for (std::size_t iteration = 0; iteration < 1000; ++iteration) {
+				DecayBatch batch;
+				FillBatch(batch, random);
+
+				float reference[DecayBatch::size];
+				float result[DecayBatch::size];
+				CalculateDecayXPReference(batch, reference);
+				CalculateDecayXP(batch, result, isa);
+
+				for (std::size_t skill = 0; skill < skillCount; ++skill) {
+					maxError = std::max(maxError, std::abs(static_cast<double>(result[skill]) - reference[skill]) / reference[skill]);
+				}
+				// Padding lanes must be safe to evaluate.
+				isFinite &= std::all_of(std::begin(result), std::end(result), [](float value) { return std::isfinite(value); });
+			}
+
+			std::printf("decay-xp/%s: max relative error %.3g\n", GetDecayKernelIsaName(isa), maxError);
+			CHECK(maxError <= bound);
+			CHECK(isFinite);
+		}
+	}
+}
+
+void RunDecayKernelTests()
+{
+	TestPow();
+	TestPowOfZero();
+	TestDecayXP();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdio>
+
+/// Number of failed checks of the test run.
+inline int failures = 0;
+
+#define CHECK(condition)                                                              \
+	do {                                                                              \
+		if (!(condition)) {                                                           \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			++failures;                                                               \
+		}                                                                             \
+	} while (false)
+
+void RunDeadlineSchedulerTests();
+void RunDecayKernelTests();
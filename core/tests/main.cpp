@@ -0,0 +1,42 @@
+#include "Tests.h"
+#include <cstdlib>
+#include <string_view>
+
+namespace
+{
+	struct Suite
+	{
+		std::string_view name;
+		void (*run)();
+	};
+
+	constexpr Suite suites[] = {
+		{ "DeadlineScheduler", RunDeadlineSchedulerTests },
+		{ "DecayKernel", RunDecayKernelTests },
+	};
+}
+
+/// Runs the suite named by the first argument, or all of them.
+int main(int argc, char* argv[])
+{
+	const std::string_view filter = argc > 1 ? argv[1] : "";
+
+	bool found = false;
+	for (const auto& suite : suites) {
+		if (filter.empty() || suite.name == filter) {
+			suite.run();
+			found = true;
+		}
+	}
+
+	if (!found) {
+		std::printf("Unknown test suite %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	if (failures > 0) {
+		std::printf("%d checks failed\n", failures);
+		return EXIT_FAILURE;
+	}
+	std::printf("All checks passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/// Interface through which other SKSE plugins can query the state of Skill Decay.
+///
+/// This header is self-contained, so it can be copied into other plugins as is.
+/// Request the interface once all plugins are loaded, e.g. in response to SKSE's kPostPostLoad message:
+///
+///     SkillDecayAPI::InterfaceRequest request{ SkillDecayAPI::InterfaceVersion::kV1 };
+///     SKSE::GetMessagingInterface()->Dispatch(SkillDecayAPI::kRequestInterface, &request, sizeof(request), SkillDecayAPI::pluginName);
+///     if (const auto api = static_cast<SkillDecayAPI::IVSkillDecay1*>(request.interface)) {
+///         const auto state = SkillDecayAPI::Read(*api->GetStateBlock());
+///     }
+///
+/// Skills are indexed in the order of the game's skills, from One-Handed (0) to Enchanting (17).
+namespace SkillDecayAPI
+{
+	/// Name that Skill Decay is registered with in SKSE.
+	constexpr const char* pluginName = "SkillDelay";
+
+	constexpr std::uint32_t skillCount = 18;
+
+	/// Type of the message that requests the interface. Its data must be an InterfaceRequest.
+	constexpr std::uint32_t kRequestInterface = 'S' << 24 | 'K' << 16 | 'D' << 8 | 'A';
+
+	enum class InterfaceVersion : std::uint32_t
+	{
+		kV1 = 1
+	};
+
+	/// Data of a kRequestInterface message.
+	/// Messages are dispatched synchronously, so interface is filled in by the time Dispatch() returns.
+	struct InterfaceRequest
+	{
+		InterfaceVersion version = InterfaceVersion::kV1;
+
+		/// Requested interface, or nullptr if the version is not supported.
+		void* interface = nullptr;
+	};
+
+	/// Decay state of a single skill.
+	struct SkillInfo
+	{
+		/// In-game hours left until the skill starts decaying, as of DecayState::daysPassed. 0 while the skill is decaying.
+		float hoursUntilDecay = 0.0f;
+
+		/// In-game days passed when the skill was last used.
+		float daysPassedWhenLastUsed = 0.0f;
+
+		std::int32_t level = 0;
+
+		/// Level below which the skill won't decay.
+		std::int32_t capLevel = 0;
+
+		std::uint32_t isDecaying = 0;
+
+		/// In-game days it takes the skill to decay a full level at its current level, once it's decaying. Infinity if it never decays.
+		float daysPerLevel = 0.0f;
+	};
+
+	/// Decay state of all skills, as of the last update of any of them.
+	struct DecayState
+	{
+		/// In-game days passed when the state was published.
+		float daysPassed = 0.0f;
+
+		/// Incremented with each publication. 0 means that nothing was published yet.
+		std::uint32_t revision = 0;
+
+		SkillInfo skills[skillCount]{};
+	};
+	static_assert(std::is_trivially_copyable_v<DecayState>);
+
+	/// Value of type T shared by a single writer with any number of readers through a seqlock.
+	///
+	/// The writer never waits for readers: sequence is odd while it is writing,
+	/// and readers simply retry if it has changed while they were copying the value.
+	/// The value is stored as atomic words, so that reading it concurrently with a write is well-defined.
+	template <typename T>
+	struct SeqLockBlock
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "SeqLockBlock can only share trivially copyable values");
+
+		static constexpr std::size_t wordCount = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+		std::atomic<std::uint32_t> sequence = 0;
+		std::atomic<std::uint64_t> words[wordCount]{};
+	};
+
+	/// Stores the value for readers. Only the owner of the block writes to it, and only from one thread at a time.
+	template <typename T>
+	void Write(SeqLockBlock<T>& block, const T& value)
+	{
+		std::uint64_t words[SeqLockBlock<T>::wordCount]{};
+		std::memcpy(words, &value, sizeof(T));
+
+		const auto sequence = block.sequence.load(std::memory_order_relaxed);
+		block.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (std::size_t i = 0; i < SeqLockBlock<T>::wordCount; ++i) {
+			block.words[i].store(words[i], std::memory_order_relaxed);
+		}
+		block.sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	/// Copies the value if no write happened meanwhile. Never blocks.
+	template <typename T>
+	bool TryRead(const SeqLockBlock<T>& block, T& value)
+	{
+		const auto before = block.sequence.load(std::memory_order_acquire);
+		if (before & 1) {
+			return false;
+		}
+
+		std::uint64_t words[SeqLockBlock<T>::wordCount];
+		for (std::size_t i = 0; i < SeqLockBlock<T>::wordCount; ++i) {
+			words[i] = block.words[i].load(std::memory_order_relaxed);
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (block.sequence.load(std::memory_order_relaxed) != before) {
+			return false;
+		}
+
+		std::memcpy(static_cast<void*>(&value), words, sizeof(T));
+		return true;
+	}
+
+	/// Copies the value, retrying while the writer is storing a new one.
+	/// Skill Decay writes its blocks in well under a microsecond and at most once per frame, so retries are rare and short.
+	template <typename T>
+	T Read(const SeqLockBlock<T>& block)
+	{
+		T value;
+		while (!TryRead(block, value)) {}
+		return value;
+	}
+
+	/// DecayState shared with readers. Read it with TryRead() or Read().
+	using StateBlock = SeqLockBlock<DecayState>;
+
+	/// Called on the game's main thread after a new state is published in which at least one skill's
+	/// level, cap level, decaying flag or last used time has changed. changedSkills has a bit set for each such skill.
+	/// Callbacks must be quick, since they run within the game's frame.
+	using ChangeCallback = void (*)(const DecayState& state, std::uint32_t changedSkills, void* context);
+
+	class IVSkillDecay1
+	{
+	public:
+		/// Block with the latest published state. The pointer stays valid for the whole lifetime of the game.
+		virtual const StateBlock* GetStateBlock() const = 0;
+
+		/// Registers the callback, returning a non-zero id to unsubscribe with.
+		virtual std::uint32_t Subscribe(ChangeCallback callback, void* context) = 0;
+		virtual void          Unsubscribe(std::uint32_t id) = 0;
+
+	protected:
+		~IVSkillDecay1() = default;
+	};
+}
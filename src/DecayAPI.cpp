@@ -0,0 +1,107 @@
+#include "DecayAPI.h"
+
+namespace Decay
+{
+	void DecayAPI::Register()
+	{
+		// Requests are addressed to us by other plugins, so we listen to all senders.
+		if (!SKSE::GetMessagingInterface()->RegisterListener(nullptr, OnMessage)) {
+			logger::error("Failed to register for interface requests. Other plugins won't be able to query Skill Decay.");
+		}
+	}
+
+	void DecayAPI::OnMessage(SKSE::MessagingInterface::Message* message)
+	{
+		if (message->type != SkillDecayAPI::kRequestInterface || message->dataLen < sizeof(SkillDecayAPI::InterfaceRequest)) {
+			return;
+		}
+
+		auto request = static_cast<SkillDecayAPI::InterfaceRequest*>(message->data);
+		switch (request->version) {
+		case SkillDecayAPI::InterfaceVersion::kV1:
+			request->interface = static_cast<SkillDecayAPI::IVSkillDecay1*>(&GetInstance());
+			logger::info("Provided interface v{} to {}", std::to_underlying(request->version), message->sender ? message->sender : "unknown plugin");
+			break;
+		default:
+			request->interface = nullptr;
+			logger::warn("{} requested unsupported interface v{}", message->sender ? message->sender : "Unknown plugin", std::to_underlying(request->version));
+			break;
+		}
+	}
+
+	void DecayAPI::Record(Skill skill, SkillUsage usage, const SkillState& skillState)
+	{
+		// Days per level are derived from level thresholds, which must match the skill's current leveling parameters
+		// even if the skill has never decayed. It's a no-op unless the parameters have changed.
+		usage.UpdateThresholds(skillState);
+
+		const SkillDecayAPI::SkillInfo info{
+			.hoursUntilDecay = 0.0f,
+			.daysPassedWhenLastUsed = usage.GetDaysPassedWhenLastUsed(),
+			.level = static_cast<std::int32_t>(skillState.GetLevel()),
+			.capLevel = usage.GetDecayCapLevel(skillState),
+			.isDecaying = usage.IsDecaying(skillState),
+			.daysPerLevel = usage.GetDaysPerLevel(skillState)
+		};
+
+		auto& current = state.skills[skill];
+		if (info.daysPassedWhenLastUsed != current.daysPassedWhenLastUsed || info.level != current.level || info.capLevel != current.capLevel || info.isDecaying != current.isDecaying) {
+			changedSkills |= 1u << skill;
+		}
+
+		current = info;
+		graceExpiry[skill] = usage.GetGraceExpiry(skillState);
+		isDirty = true;
+	}
+
+	void DecayAPI::Publish(float daysPassed)
+	{
+		if (!isDirty) {
+			return;
+		}
+		isDirty = false;
+
+		state.daysPassed = daysPassed;
+		state.revision += 1;
+		for (std::uint32_t skill = 0; skill < Skill::kTotal; ++skill) {
+			auto& info = state.skills[skill];
+			info.hoursUntilDecay = info.isDecaying ? 0.0f : std::max(0.0f, (graceExpiry[skill] - daysPassed) * 24.0f);
+		}
+
+		SkillDecayAPI::Write(block, state);
+
+		if (changedSkills == 0) {
+			return;
+		}
+
+		// Callbacks are called without holding the lock, so that they can (un)subscribe themselves.
+		std::vector<Subscriber> notified;
+		{
+			std::scoped_lock lock(subscribersLock);
+			notified = subscribers;
+		}
+
+		const auto changed = std::exchange(changedSkills, 0);
+		for (const auto& subscriber : notified) {
+			subscriber.callback(state, changed, subscriber.context);
+		}
+	}
+
+	std::uint32_t DecayAPI::Subscribe(SkillDecayAPI::ChangeCallback callback, void* context)
+	{
+		if (!callback) {
+			return 0;
+		}
+
+		std::scoped_lock lock(subscribersLock);
+		const auto       id = nextSubscriberId++;
+		subscribers.push_back({ id, callback, context });
+		return id;
+	}
+
+	void DecayAPI::Unsubscribe(std::uint32_t id)
+	{
+		std::scoped_lock lock(subscribersLock);
+		std::erase_if(subscribers, [&](const Subscriber& subscriber) { return subscriber.id == id; });
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Decay/SkillUsage.h"
+#include "SkillDecayAPI.h"
+
+namespace Decay
+{
+	/// Implementation of SkillDecayAPI for other plugins.
+	///
+	/// DecayTracker records skills as they are updated or used, and all changes of a frame are published at once,
+	/// so that readers never see a half-updated set of skills and the game thread never waits for them.
+	class DecayAPI final : public SkillDecayAPI::IVSkillDecay1
+	{
+	public:
+		static DecayAPI& GetInstance()
+		{
+			static DecayAPI instance;
+			return instance;
+		}
+
+		/// Starts answering interface requests of other plugins.
+		static void Register();
+
+		/// Records current state of the skill, to be published with the next Publish().
+		void Record(Skill skill, SkillUsage usage, const SkillState& state);
+
+		/// Publishes recorded skills, if any, and notifies subscribers about skills that have changed.
+		void Publish(float daysPassed);
+
+		const SkillDecayAPI::StateBlock* GetStateBlock() const override { return &block; }
+
+		std::uint32_t Subscribe(SkillDecayAPI::ChangeCallback callback, void* context) override;
+		void          Unsubscribe(std::uint32_t id) override;
+
+	private:
+		struct Subscriber
+		{
+			std::uint32_t                 id;
+			SkillDecayAPI::ChangeCallback callback;
+			void*                         context;
+		};
+
+		SkillDecayAPI::StateBlock block;
+
+		/// State that is being built by Record() calls. Only accessed on the game thread.
+		SkillDecayAPI::DecayState state;
+
+		/// Days passed when the grace period of each skill runs out, from which hoursUntilDecay is derived on publication.
+		float graceExpiry[Skill::kTotal]{};
+
+		/// Whether anything was recorded since the last publication, and which skills have changed in a way that subscribers are notified about.
+		bool          isDirty = false;
+		std::uint32_t changedSkills = 0;
+
+		/// Subscriptions might come from any thread, so they are guarded. The game thread only holds the lock to copy them before notifying.
+		std::mutex              subscribersLock;
+		std::vector<Subscriber> subscribers;
+		std::uint32_t           nextSubscriberId = 1;
+
+		static void OnMessage(SKSE::MessagingInterface::Message*);
+	};
+}
@@ -0,0 +1,287 @@
+#include "DecayOptions.h"
+#include "CLIBUtil/simpleINI.hpp"
+#include "CLIBUtil/string.hpp"
+
+namespace Decay
+{
+	/// INI sections with settings of each skill.
+	constexpr const char* sections[Skill::kTotal] = {
+		"OneHanded",
+		"TwoHanded",
+		"Archery",
+		"Block",
+		"Smithing",
+		"HeavyArmor",
+		"LightArmor",
+		"Pickpocket",
+		"Lockpicking",
+		"Sneaking",
+		"Alchemy",
+		"Speech",
+		"Alteration",
+		"Conjuration",
+		"Destruction",
+		"Illusion",
+		"Restoration",
+		"Enchanting"
+	};
+
+	void ReadSettings(const CSimpleIniA& ini, const char* section, SkillConfig& config)
+	{
+		if (ini.SectionExists(section)) {
+			config.gracePeriod = ini.GetDoubleValue(section, "fDecayGracePeriod", config.gracePeriod);
+			config.interval = ini.GetDoubleValue(section, "fDecayInterval", config.interval);
+			config.levelOffset = ini.GetLongValue(section, "iDecayLevelOffset", config.levelOffset);
+			config.baselineLevelOffset = ini.GetLongValue(section, "iBaselineLevelOffset", config.baselineLevelOffset);
+			config.damping = ini.GetDoubleValue(section, "fDecayXPDamping", config.damping);
+			config.difficultyMult = ini.GetDoubleValue(section, "fDecayXPDifficultyMult", config.difficultyMult);
+			config.levelCap = ini.GetLongValue(section, "iDecayLevelCap", config.levelCap);
+			config.legendarySkillDamping = ini.GetDoubleValue(section, "fLegendarySkillXPDamping", config.legendarySkillDamping);
+			config.minDaysPerLevel = ini.GetDoubleValue(section, "fMinDaysPerLevel", config.minDaysPerLevel);
+			config.maxDaysPerLevel = ini.GetDoubleValue(section, "fMaxDaysPerLevel", config.maxDaysPerLevel);
+			config.difficultyOverride = ini.GetLongValue(section, "iDifficulty", config.difficultyOverride);
+
+			std::string color = ini.GetValue(section, "cDecayTint", "");
+
+			if (!color.empty()) {
+				config.decayTint = clib_util::string::to_color(color, config.decayTint);
+			}
+
+			color = ini.GetValue(section, "cTint", "");
+
+			if (!color.empty()) {
+				config.normalTint = clib_util::string::to_color(color, config.normalTint);
+			}
+
+			std::string rawLayers = ini.GetValue(section, "sUILayers", "");
+			auto        layers = clib_util::string::split(rawLayers, ",");
+			for (auto& layer : layers) {
+				clib_util::string::trim(layer);
+			}
+
+			if (!layers.empty()) {
+				config.uiLayers = std::move(layers);
+			}
+		}
+	}
+
+	DecayOptions::DecayOptions()
+	{
+		// These are valid indices for instances present in each SkillText's ShortBar.
+		// SkillText0: 94-97 // Enchanting
+		// SkillText1: 100-103 // Smithing
+		// SkillText2: 106-109 // Heavy Armor
+		// SkillText3: 112-115 // Block
+		// SkillText4: 118-121 // Two-Handed
+		// SkillText5: 124-127 // One-Handed
+		// SkillText6: 130-133 // Archery
+		// SkillText7: 136-139 // Light Armor
+		// SkillText8: 142-145 // Sneaking
+		// SkillText9: 148-151 // Lockpicking
+		// SkillText10: 154-157 // Pickpocket
+		// SkillText11: 160-163 // Speech
+		// SkillText12: 166-169 // Alchemy
+		// SkillText13: 172-175 // Illusion
+		// SkillText14: 178-181 // Conjuration
+		// SkillText15: 184-187 // Destruction
+		// SkillText16: 190-193 // Restoration
+		// SkillText17: 196-199 // Alteration
+
+		// By default we target the primary color of the bar as well as the background. Other instances control "reflection" and "shadow" effects applied to the bar.
+		const SkillConfig defaults[Skill::kTotal] = {
+			/* One-Handed */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText5.ShortBar.instance124", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText5.ShortBar.instance126" }),
+			/* Two-Handed */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText4.ShortBar.instance118", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText4.ShortBar.instance120" }),
+			/* Archery */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText6.ShortBar.instance130", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText6.ShortBar.instance132" }),
+			/* Block */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText3.ShortBar.instance112", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText3.ShortBar.instance114" }),
+			/* Smithing */ SkillConfig(2, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText1.ShortBar.instance100", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText1.ShortBar.instance102" }),
+			/* Heavy Armor */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText2.ShortBar.instance106", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText2.ShortBar.instance108" }),
+			/* Light Armor */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText7.ShortBar.instance136", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText7.ShortBar.instance138" }),
+			/* Pickpocket */ SkillConfig(2, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText10.ShortBar.instance154", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText10.ShortBar.instance156" }),
+			/* Lockpicking */ SkillConfig(2, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText9.ShortBar.instance148", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText9.ShortBar.instance150" }),
+			/* Sneaking */ SkillConfig(1.5f, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText8.ShortBar.instance142", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText8.ShortBar.instance144" }),
+			/* Alchemy */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText12.ShortBar.instance166", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText12.ShortBar.instance168" }),
+			/* Speech */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText11.ShortBar.instance160", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText11.ShortBar.instance162" }),
+			/* Alteration */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText17.ShortBar.instance196", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText17.ShortBar.instance198" }),
+			/* Conjuration */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText14.ShortBar.instance178", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText14.ShortBar.instance180" }),
+			/* Destruction */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText15.ShortBar.instance184", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText15.ShortBar.instance186" }),
+			/* Illusion */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText13.ShortBar.instance172", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText13.ShortBar.instance174" }),
+			/* Restoration */ SkillConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText16.ShortBar.instance190", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText16.ShortBar.instance192" }),
+			/* Enchanting */ SkillConfig(1.25f, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText0.ShortBar.instance94", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText0.ShortBar.instance96" })
+		};
+
+		std::ranges::copy(defaults, skills);
+	}
+
+	DecayOptions DecayOptions::Parse(const std::filesystem::path& file)
+	{
+		DecayOptions options;
+		CSimpleIniA  ini{};
+		ini.SetUnicode();
+		ini.SetMultiKey(false);
+
+		if (ini.LoadFile(file.string().c_str()) >= 0) {
+			const float defaultTrackingRate = options.trackingRate;
+			options.isLoaded = true;
+			options.trackingRate = ini.GetDoubleValue("", "fTrackingRate", options.trackingRate);
+			options.exactDecay = ini.GetBoolValue("", "bExactDecay", options.exactDecay);
+			options.logSkillUsage = ini.GetBoolValue("", "bLogSkillUsage", options.logSkillUsage);
+			options.logTransitionsOnly = ini.GetBoolValue("", "bLogSkillTransitionsOnly", options.logTransitionsOnly);
+			options.asyncLog = ini.GetBoolValue("", "bAsyncSkillLog", options.asyncLog);
+			options.recordJournal = ini.GetBoolValue("", "bRecordJournal", options.recordJournal);
+			options.hotReload = ini.GetBoolValue("", "bHotReload", options.hotReload);
+			options.hookStatsInterval = ini.GetDoubleValue("", "fHookStatsInterval", options.hookStatsInterval);
+			if (options.trackingRate <= 0) {
+				options.trackingRate = defaultTrackingRate;
+			}
+
+			for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
+				SkillConfig& config = options.skills[skill];
+				SkillConfig  defaults = config;
+				const char*  section = sections[skill];
+
+				// We load settings in 3 passes:
+				// 1) Load default values for all the skills
+				// 2) Load skill-specific custom values
+				// 3) Load forced global values that all skills will use.
+
+				// Load global overwrites for all skills first.
+				ReadSettings(ini, "", config);
+
+				// Then apply skill-specific settings, if they exist.
+				ReadSettings(ini, section, config);
+
+				// Finally, apply another global overwrites that are supposed to affect all skills.
+				ReadSettings(ini, "All", config);
+
+				// Lastly we want to validate input
+				if (config.interval <= 0) {
+					config.interval = defaults.interval;
+				}
+
+				if (config.damping <= 0) {
+					config.damping = defaults.damping;
+				}
+
+				if (config.legendarySkillDamping < 1) {
+					config.legendarySkillDamping = defaults.legendarySkillDamping;
+				}
+
+				if (config.minDaysPerLevel < 0) {
+					config.minDaysPerLevel = defaults.minDaysPerLevel;
+				}
+
+				if (config.maxDaysPerLevel < 0) {
+					config.maxDaysPerLevel = defaults.maxDaysPerLevel;
+				} else if (config.maxDaysPerLevel < config.minDaysPerLevel) {
+					config.maxDaysPerLevel = config.minDaysPerLevel + config.maxDaysPerLevel;
+				}
+
+				config.difficultyOverride = min(config.difficultyOverride, 5);
+			}
+		}
+
+		return options;
+	}
+
+	FileStamp FileStamp::Of(const std::filesystem::path& file)
+	{
+		FileStamp       stamp;
+		std::error_code error;
+		stamp.modified = std::filesystem::last_write_time(file, error);
+		if (error) {
+			return {};
+		}
+		stamp.size = std::filesystem::file_size(file, error);
+		if (error) {
+			return {};
+		}
+		stamp.exists = true;
+		return stamp;
+	}
+
+	bool DecayOptionsCache::Update()
+	{
+		const auto current = FileStamp::Of(file);
+		if (stamp && *stamp == current) {
+			return false;
+		}
+
+		options = current.exists ? DecayOptions::Parse(file) : DecayOptions();
+		stamp = current;
+		return true;
+	}
+
+	bool DecayOptionsCache::Adopt(const FileStamp& a_stamp, DecayOptions&& a_options)
+	{
+		if (stamp && *stamp == a_stamp) {
+			return false;
+		}
+
+		options = std::move(a_options);
+		stamp = a_stamp;
+		return true;
+	}
+
+	DecayOptionsWatcher::~DecayOptionsWatcher()
+	{
+		Stop();
+	}
+
+	void DecayOptionsWatcher::Start(const std::filesystem::path& file, const FileStamp& knownStamp)
+	{
+		if (worker.joinable()) {
+			return;
+		}
+
+		worker = std::jthread([this, file, knownStamp](std::stop_token token) {
+			// Checking the stamp is a single stat call, but there is still no need to do it more often than once per second.
+			constexpr auto pollInterval = 1s;
+
+			FileStamp stamp = knownStamp;
+
+			// Nothing else ever notifies the condition, so the wait only ends once the interval passes or Stop() requests to stop,
+			// in which case it wakes up right away instead of holding up the game thread that joins us.
+			std::unique_lock lock(stopLock);
+			while (!stopCondition.wait_for(lock, token, pollInterval, [&token] { return token.stop_requested(); })) {
+				const auto current = FileStamp::Of(file);
+				if (current == stamp) {
+					continue;
+				}
+				stamp = current;
+
+				auto snapshot = std::make_unique<Snapshot>();
+				snapshot->stamp = current;
+				if (current.exists) {
+					snapshot->options = DecayOptions::Parse(file);
+				}
+				Publish(std::move(snapshot));
+			}
+		});
+	}
+
+	void DecayOptionsWatcher::Stop()
+	{
+		if (worker.joinable()) {
+			worker.request_stop();
+			worker.join();
+		}
+		// Nobody is going to take it anymore.
+		delete pending.exchange(nullptr, std::memory_order_acquire);
+	}
+
+	void DecayOptionsWatcher::Publish(std::unique_ptr<Snapshot> snapshot)
+	{
+		// If the previous snapshot wasn't taken yet, it is outdated and can be safely deleted,
+		// since the game thread can only get it through the same exchange.
+		delete pending.exchange(snapshot.release(), std::memory_order_acq_rel);
+	}
+
+	std::unique_ptr<DecayOptionsWatcher::Snapshot> DecayOptionsWatcher::Take()
+	{
+		// Cheap check for the common case, when nothing was published.
+		if (!pending.load(std::memory_order_relaxed)) {
+			return nullptr;
+		}
+		return std::unique_ptr<Snapshot>(pending.exchange(nullptr, std::memory_order_acquire));
+	}
+}
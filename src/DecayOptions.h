@@ -0,0 +1,155 @@
+#pragma once
+#include "Decay/DecayConfig.h"
+
+namespace Decay
+{
+	/// Appearance of the skill's level meter in StatsMenu.
+	struct TintConfig
+	{
+		/// Paths to the skill level meter UI elements for each skill, used for applying color tint when decaying.
+		std::vector<std::string> uiLayers;
+
+		/// Color of the tint to be applied to the skill level meter UI elements when the skill is decaying.
+		RE::GColor decayTint = { 255, 60, 0, 200 };
+
+		/// Color of the tint to be applied to the skill level meter UI elements when the skill is not decaying.
+		/// Provided just for fun if some people would like to recolor their skill meters.
+		RE::GColor normalTint = { 0, 0, 0, 0 };
+	};
+
+	/// All settings of a skill that can be configured in the INI.
+	struct SkillConfig : DecayConfig, TintConfig
+	{
+		SkillConfig() = default;
+		SkillConfig(std::vector<std::string> layers)
+		{
+			uiLayers = std::move(layers);
+		}
+		SkillConfig(float damping, std::vector<std::string> layers) :
+			DecayConfig(damping)
+		{
+			uiLayers = std::move(layers);
+		}
+	};
+
+	/// Options of Skill Decay as they are set in SkillDecay.ini.
+	/// Options only depend on the file, so once parsed they can be reused until the file changes.
+	struct DecayOptions
+	{
+		/// Hours between SkillUsage updates of decaying skills.
+		float trackingRate = 0.016f;  // once every in-game minute by default
+
+		/// Whether decay is integrated exactly between updates, so that coarse tracking rates yield the same results as fine ones.
+		bool exactDecay = false;
+
+		bool logSkillUsage = false;
+		bool logTransitionsOnly = false;
+		bool asyncLog = true;
+
+		/// Whether each session is recorded to a binary journal next to the log, for offline inspection with SkillDecayJournal.
+		bool recordJournal = false;
+
+		/// Whether changes to the INI are picked up while the game is running.
+		bool hotReload = true;
+
+		/// Real-time seconds between dumps of hook latency histograms. Zero only dumps them on save.
+		/// Only used when the plugin is built with PROFILE_HOOKS.
+		float hookStatsInterval = 0.0f;
+
+		/// Whether options were read from the file. Otherwise, they are the defaults.
+		bool isLoaded = false;
+
+		/// Validated settings of each skill, with player-dependent values (e.g. automatic baselineLevelOffset) left unresolved.
+		SkillConfig skills[Skill::kTotal];
+
+		DecayOptions();
+
+		/// Reads and validates options from the INI file.
+		/// Options that are not set in the file keep their default values.
+		static DecayOptions Parse(const std::filesystem::path& file);
+	};
+
+	/// Identity of a file's contents, as far as the file system can tell without reading it.
+	struct FileStamp
+	{
+		bool                            exists = false;
+		std::filesystem::file_time_type modified{};
+		std::uintmax_t                  size = 0;
+
+		static FileStamp Of(const std::filesystem::path& file);
+
+		bool operator==(const FileStamp&) const = default;
+	};
+
+	/// Parsed options of an INI file, which are only parsed again when the file is modified.
+	class DecayOptionsCache
+	{
+	public:
+		explicit DecayOptionsCache(std::filesystem::path file) :
+			file(std::move(file))
+		{}
+
+		/// Re-parses the file if it has changed since the last call.
+		/// Returns true when options were parsed.
+		bool Update();
+
+		/// Replaces options with the ones that were parsed elsewhere from the given version of the file.
+		/// Returns false if options of that version are already cached.
+		bool Adopt(const FileStamp& stamp, DecayOptions&& options);
+
+		/// Options as of the last Update() or Adopt().
+		const DecayOptions& Get() const { return options; }
+
+		/// Stamp of the file that current options were parsed from.
+		FileStamp GetStamp() const { return stamp.value_or(FileStamp{}); }
+
+		const std::filesystem::path& GetFile() const { return file; }
+
+	private:
+		std::filesystem::path file;
+		DecayOptions          options;
+
+		/// Stamp of the file that options were parsed from. Empty until the first Update().
+		std::optional<FileStamp> stamp;
+	};
+
+	/// Watches an INI file in the background, and parses it as soon as it changes.
+	///
+	/// Parsed options are handed over to the game thread through a single atomic pointer,
+	/// so neither of the threads ever waits for the other one.
+	class DecayOptionsWatcher
+	{
+	public:
+		/// Immutable options of a specific version of the file.
+		struct Snapshot
+		{
+			FileStamp    stamp;
+			DecayOptions options;
+		};
+
+		~DecayOptionsWatcher();
+
+		/// Starts watching the file for changes made after the given version.
+		void Start(const std::filesystem::path& file, const FileStamp& knownStamp);
+		void Stop();
+
+		bool IsRunning() const { return worker.joinable(); }
+
+		/// Takes the most recent snapshot that was published since the last call, if any.
+		/// Older snapshots that were never taken are discarded by the watcher.
+		std::unique_ptr<Snapshot> Take();
+
+	private:
+		std::jthread worker;
+
+		/// Condition that the worker waits on between polls, so that a stop request wakes it up immediately.
+		std::mutex                  stopLock;
+		std::condition_variable_any stopCondition;
+
+		/// Owning pointer to the snapshot that awaits to be taken.
+		std::atomic<Snapshot*> pending = nullptr;
+
+		/// Replaces pending snapshot with the new one.
+		void Publish(std::unique_ptr<Snapshot> snapshot);
+	};
+}
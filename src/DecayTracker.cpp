@@ -1,368 +1,395 @@
 #include "DecayTracker.h"
-#include "CLIBUtil/simpleINI.hpp"
-#include "CLIBUtil/string.hpp"
+#include "Decay/Serialization.h"
+#include "DecayAPI.h"
+#include "HookProfiler.h"
 #include "Options.h"
 
-#define Inc(skill) \
-	skill = static_cast<Skill>(static_cast<std::underlying_type_t<Skill>>(skill) + 1)
-
 namespace Decay
 {
 	void DecayTracker::AdvanceTime(RE::Calendar* calendar)
 	{
-		float daysPassed = calendar->GetDaysPassed();
-		float hoursPassed = (daysPassed - lastDaysPassed) * 24.0;
+		// Settings are only ever reloaded here, so that skills are never re-initialized in the middle of an update from another thread.
+		if (isReloadRequested.load(std::memory_order_relaxed) && isReloadRequested.exchange(false)) {
+			LoadSettings();
+		}
+		ReloadOptions();
+
+		const float daysPassed = calendar->GetDaysPassed();
+		if (daysPassed != journalDaysPassed && journal.IsOpen()) {
+			journal.RecordTick(daysPassed, daysPassed - journalDaysPassed);
+			journalDaysPassed = daysPassed;
+		}
 
-		if (hoursPassed > trackingRate) {
-			lastDaysPassed = daysPassed;
-			UpdateSkillUsage(calendar);
+		if (updater.IsDue(daysPassed)) {
+			UpdateSkillUsage(calendar, true);
 		}
+
+		// Skills that were used since the last frame are published along with the updated ones.
+		DecayAPI::GetInstance().Publish(daysPassed);
 	}
 
-	void ReadSettings(const CSimpleIniA& ini, const char* section, DecayConfig& config)
+	void DecayTracker::SkillUsed(RE::ActorValue av)
 	{
-		if (ini.SectionExists(section)) {
-			config.gracePeriod = ini.GetDoubleValue(section, "fDecayGracePeriod", config.gracePeriod);
-			config.interval = ini.GetDoubleValue(section, "fDecayInterval", config.interval);
-			config.levelOffset = ini.GetLongValue(section, "iDecayLevelOffset", config.levelOffset);
-			config.baselineLevelOffset = ini.GetLongValue(section, "iBaselineLevelOffset", config.baselineLevelOffset);
-			config.damping = ini.GetDoubleValue(section, "fDecayXPDamping", config.damping);
-			config.difficultyMult = ini.GetDoubleValue(section, "fDecayXPDifficultyMult", config.difficultyMult);
-			config.levelCap = ini.GetLongValue(section, "iDecayLevelCap", config.levelCap);
-			config.legendarySkillDamping = ini.GetDoubleValue(section, "fLegendarySkillXPDamping", config.legendarySkillDamping);
-			config.minDaysPerLevel = ini.GetDoubleValue(section, "fMinDaysPerLevel", config.minDaysPerLevel);
-			config.maxDaysPerLevel = ini.GetDoubleValue(section, "fMaxDaysPerLevel", config.maxDaysPerLevel);
-			config.difficultyOverride = ini.GetLongValue(section, "iDifficulty", config.difficultyOverride);
-
-			std::string color = ini.GetValue(section, "cDecayTint", "");
-
-			if (!color.empty()) {
-				config.decayTint = clib_util::string::to_color(color, config.decayTint);
+		const auto skillIndex = static_cast<std::underlying_type_t<RE::ActorValue>>(av) - 6;
+		if (skillIndex < 0 || skillIndex >= Skill::kTotal)
+			return;
+
+		// Uninitialized usages will be picked up by the next UpdateSkillUsage().
+		if (auto usage = skillUsages[skillIndex]; usage.IsInitialized()) {
+			const auto calendar = RE::Calendar::GetSingleton();
+			auto&      state = skillStates[skillIndex];
+			const bool wasDecaying = updater.SetUsed(static_cast<std::size_t>(skillIndex), state, CalendarClock(calendar));
+			if (journal.IsOpen()) {
+				journal.RecordSkill(static_cast<std::size_t>(skillIndex), SkillEvent::kUsed, calendar->GetDaysPassed(), state.GetLevel(), usage.GetDecayCapLevel(state), state.GetProgress().xp);
+			}
+			if (wasDecaying) {
+				PublishTintState();
 			}
+			DecayAPI::GetInstance().Record(static_cast<Skill>(skillIndex), usage, skillStates[skillIndex]);
+		}
+	}
 
-			color = ini.GetValue(section, "cTint", "");
+	void LogOptions(const DecayOptions& options)
+	{
+		if (!options.isLoaded) {
+			logger::info(R"(Data\SKSE\Plugins\SkillDecay.ini not found. Default options will be used.)");
+			logger::info("");
+		}
 
-			if (!color.empty()) {
-				config.normalTint = clib_util::string::to_color(color, config.normalTint);
-			}
+		if (options.logSkillUsage) {
+			logger::info("Logging Skill Usage enabled ({}, {})", options.logTransitionsOnly ? "transitions only" : "all skills", options.asyncLog ? "async" : "sync");
+		} else {
+			logger::info("Logging Skill Usage disabled");
+		}
+		auto formattedRate = options.trackingRate < 1.0f ? std::format("{:.2f} in-game minutes", options.trackingRate * 60.0f) : std::format("{:.2f} in-game hours", options.trackingRate);
+		logger::info("Tracking Rate: once every {}{}", formattedRate, options.exactDecay ? " (exact decay)" : "");
+		logger::info("Decay journal {}", options.recordJournal ? "enabled" : "disabled");
+#ifdef PROFILE_HOOKS
+		logger::info("Hook latency is logged {}", options.hookStatsInterval > 0 ? std::format("every {:.0f}s and on save", options.hookStatsInterval) : "on save");
+#endif
 
-			std::string rawLayers = ini.GetValue(section, "sUILayers", "");
-			auto        layers = clib_util::string::split(rawLayers, ",");
-			for (auto& layer : layers) {
-				clib_util::string::trim(layer);
-			}
+		constexpr std::string_view difficultyNames[] = { "Novice", "Apprentice", "Adept", "Expert", "Master", "Legendary" };
 
-			if (!layers.empty()) {
-				config.uiLayers = std::move(layers);
-			}
+		logger::info("{:>11} | {:^12} | {:^14} | {:^15} | {:^12} | {:^10} | {:^15} | {:^7} | {:^17} | {:^9} | {:^14} | {:^14}",
+			"Skill", "Grace Period", "Decay Duration", "Baseline Offset", "Extra Offset", "Difficulty", "Difficulty Mult", "Damping", "Legendary Damping", "Decay Cap", "Min Decay Days", "Max Decay Days");
+		for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
+			const auto& config = options.skills[skill];
+			const auto  name = SkillName(skill);
+			logger::info("{:>11} | {:^12} | {:^14} | {:^15} | {:^12} | {:^10} | {:^15} | {:^7} | {:^17} | {:^9} | {:^14} | {:^14}",
+				name,
+				std::signbit(config.gracePeriod) ? "Auto" : std::format("{:.1f}h", config.gracePeriod),
+				std::format("{:.1f}h", config.interval),
+				config.baselineLevelOffset < 0 ? "Auto" : std::format("{}", config.baselineLevelOffset),
+				config.levelOffset,
+				config.difficultyOverride < 0 ? "Auto" : difficultyNames[config.difficultyOverride],
+				std::signbit(config.difficultyMult) ? "Auto" : std::format("{:.2f}", config.difficultyMult),
+				std::format("/{:.2f}", config.damping),
+				std::format("+{:.0f}%", (config.legendarySkillDamping - 1) * 100.0f),
+				config.levelCap == 0 ? "Base" : std::format("{}", config.levelCap),
+				std::format("{:.1f}d", config.minDaysPerLevel),
+				std::format("{:.1f}d", config.maxDaysPerLevel));
 		}
 	}
 
 	void DecayTracker::LoadSettings()
 	{
 		logger::info("{:*^30}", " OPTIONS ");
-		std::filesystem::path options = R"(Data\SKSE\Plugins\SkillDecay.ini)";
-		CSimpleIniA           ini{};
-		ini.SetUnicode();
-		ini.SetMultiKey(false);
-
-		// These are valid indices for instances present in each SkillText's ShortBar.
-		// SkillText0: 94-97 // Enchanting
-		// SkillText1: 100-103 // Smithing
-		// SkillText2: 106-109 // Heavy Armor
-		// SkillText3: 112-115 // Block
-		// SkillText4: 118-121 // Two-Handed
-		// SkillText5: 124-127 // One-Handed
-		// SkillText6: 130-133 // Archery
-		// SkillText7: 136-139 // Light Armor
-		// SkillText8: 142-145 // Sneaking
-		// SkillText9: 148-151 // Lockpicking
-		// SkillText10: 154-157 // Pickpocket
-		// SkillText11: 160-163 // Speech
-		// SkillText12: 166-169 // Alchemy
-		// SkillText13: 172-175 // Illusion
-		// SkillText14: 178-181 // Conjuration
-		// SkillText15: 184-187 // Destruction
-		// SkillText16: 190-193 // Restoration
-		// SkillText17: 196-199 // Alteration
-
-		// By default we target the primary color of the bar as well as the background. Other instances control "reflection" and "shadow" effects applied to the bar.
-		DecayConfig configs[Skill::kTotal] = {
-			/* One-Handed */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText5.ShortBar.instance124", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText5.ShortBar.instance126" }),
-			/* Two-Handed */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText4.ShortBar.instance118", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText4.ShortBar.instance120" }),
-			/* Archery */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText6.ShortBar.instance130", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText6.ShortBar.instance132" }),
-			/* Block */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText3.ShortBar.instance112", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText3.ShortBar.instance114" }),
-			/* Smithing */ DecayConfig(2, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText1.ShortBar.instance100", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText1.ShortBar.instance102" }),
-			/* Heavy Armor */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText2.ShortBar.instance106", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText2.ShortBar.instance108" }),
-			/* Light Armor */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText7.ShortBar.instance136", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText7.ShortBar.instance138" }),
-			/* Pickpocket */ DecayConfig(2, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText10.ShortBar.instance154", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText10.ShortBar.instance156" }),
-			/* Lockpicking */ DecayConfig(2, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText9.ShortBar.instance148", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText9.ShortBar.instance150" }),
-			/* Sneaking */ DecayConfig(1.5f, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText8.ShortBar.instance142", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText8.ShortBar.instance144" }),
-			/* Alchemy */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText12.ShortBar.instance166", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText12.ShortBar.instance168" }),
-			/* Speech */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText11.ShortBar.instance160", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText11.ShortBar.instance162" }),
-			/* Alteration */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText17.ShortBar.instance196", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText17.ShortBar.instance198" }),
-			/* Conjuration */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText14.ShortBar.instance178", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText14.ShortBar.instance180" }),
-			/* Destruction */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText15.ShortBar.instance184", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText15.ShortBar.instance186" }),
-			/* Illusion */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText13.ShortBar.instance172", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText13.ShortBar.instance174" }),
-			/* Restoration */ DecayConfig({ "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText16.ShortBar.instance190", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText16.ShortBar.instance192" }),
-			/* Enchanting */ DecayConfig(1.25f, { "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText0.ShortBar.instance94", "_root.StatsMenuBaseInstance.AnimatingSkillTextInstance.SkillText0.ShortBar.instance96" })
-		};
-
-		const std::string sections[Skill::kTotal] = {
-			"OneHanded",
-			"TwoHanded",
-			"Archery",
-			"Block",
-			"Smithing",
-			"HeavyArmor",
-			"LightArmor",
-			"Pickpocket",
-			"Lockpicking",
-			"Sneaking",
-			"Alchemy",
-			"Speech",
-			"Alteration",
-			"Conjuration",
-			"Destruction",
-			"Illusion",
-			"Restoration",
-			"Enchanting"
-		};
-
-		if (ini.LoadFile(options.string().c_str()) >= 0) {
-			float defaultTrackingRate = trackingRate;
-			trackingRate = ini.GetDoubleValue("", "fTrackingRate", trackingRate);
-			logSkillUsage = ini.GetBoolValue("", "bLogSkillUsage", logSkillUsage);
-			if (trackingRate <= 0) {
-				trackingRate = defaultTrackingRate;
-			}
+		Settings::Refresh();
 
-			for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
-				DecayConfig& config = configs[skill];
-				DecayConfig  defaults = config;
-				const char*  section = sections[skill].c_str();
+		// Watcher might have already parsed the latest version of the file.
+		if (auto snapshot = optionsWatcher.Take(); snapshot && optionsCache.Adopt(snapshot->stamp, std::move(snapshot->options))) {
+			ApplyOptions();
+		}
 
-				// We load settings in 3 passes:
-				// 1) Load default values for all the skills
-				// 2) Load skill-specific custom values
-				// 3) Load forced global values that all skills will use.
+		// Options only need to be applied when the file has changed,
+		// while race skill bonuses must be resolved on every call, since Player might've changed race.
+		if (optionsCache.Update()) {
+			ApplyOptions();
+		} else {
+			logger::info("SkillDecay.ini has not changed. Reusing loaded options.");
+		}
 
-				// Load global overwrites for all skills first.
-				ReadSettings(ini, "", config);
+		InitSkills();
+	}
 
-				// Then apply skill-specific settings, if they exist.
-				ReadSettings(ini, section, config);
+	void DecayTracker::ReloadOptions()
+	{
+		auto snapshot = optionsWatcher.Take();
+		if (!snapshot || !optionsCache.Adopt(snapshot->stamp, std::move(snapshot->options))) {
+			return;
+		}
 
-				// Finally, apply another global overwrites that are supposed to affect all skills.
-				ReadSettings(ini, "All", config);
+		logger::info("{:*^30}", " OPTIONS ");
+		logger::info("SkillDecay.ini has changed. Applying new options.");
+		ApplyOptions();
+		InitSkills();
+	}
 
-				// Lastly we want to validate input
-				if (config.interval <= 0) {
-					config.interval = defaults.interval;
-				}
+	void DecayTracker::ApplyOptions()
+	{
+		const auto& options = optionsCache.Get();
+		LogOptions(options);
 
-				if (config.damping <= 0) {
-					config.damping = defaults.damping;
-				}
+		updater.trackingRate = options.trackingRate;
+		updater.mode = options.exactDecay ? UpdateMode::kExact : UpdateMode::kStep;
 
-				if (config.legendarySkillDamping < 1) {
-					config.legendarySkillDamping = defaults.legendarySkillDamping;
-				}
+		auto traceMode = SkillTrace::Mode::kOff;
+		if (options.logSkillUsage) {
+			traceMode = options.logTransitionsOnly ? SkillTrace::Mode::kTransitions : SkillTrace::Mode::kFull;
+		}
+		trace.Configure(traceMode, options.asyncLog);
+		ConfigureJournal(options.recordJournal);
 
-				if (config.minDaysPerLevel < 0) {
-					config.minDaysPerLevel = defaults.minDaysPerLevel;
-				}
+		// Configs might've changed tints and UI layers. The UI thread might still be using the previous configs,
+		// so new ones are published alongside them, and it picks them up once it sees the new revision.
+		auto configs = std::make_unique<TintConfigs>();
+		for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
+			(*configs)[skill] = options.skills[skill];
+		}
+		RetireTintConfigs();
+		tintConfigsRevision += 1;
+		publishedTintConfigs.push_back({ tintConfigsRevision, std::move(configs) });
+		PublishTintState();
 
-				if (config.maxDaysPerLevel < 0) {
-					config.maxDaysPerLevel = defaults.maxDaysPerLevel;
-				} else if (config.maxDaysPerLevel < config.minDaysPerLevel) {
-					config.maxDaysPerLevel = config.minDaysPerLevel + config.maxDaysPerLevel;
-				}
+		HookProfiler::SetInterval(options.hookStatsInterval);
 
-				config.difficultyOverride = min(config.difficultyOverride, 5);
-			}
+		if (options.hotReload) {
+			optionsWatcher.Start(optionsCache.GetFile(), optionsCache.GetStamp());
 		} else {
-			logger::info(R"(Data\SKSE\Plugins\SkillDecay.ini not found. Default options will be used.)");
-			logger::info("");
+			optionsWatcher.Stop();
 		}
+	}
 
-		logger::info("{}", logSkillUsage ? "Logging Skill Usage enabled" : "Logging Skill Usage disabled");
-		auto formattedRate = trackingRate < 1.0f ? std::format("{:.2f} in-game minutes", trackingRate * 60.0f) : std::format("{:.2f} in-game hours", trackingRate);
-		logger::info("Tracking Rate: once every {}", formattedRate);
+	void DecayTracker::ConfigureJournal(bool isEnabled)
+	{
+		if (!isEnabled) {
+			journal.Close();
+			return;
+		}
+		if (journal.IsOpen()) {
+			return;
+		}
 
-		constexpr std::string_view difficultyNames[] = { "Novice", "Apprentice", "Adept", "Expert", "Master", "Legendary" };
+		auto path = SKSE::log::log_directory();
+		if (!path) {
+			logger::error("Failed to find logging directory. Decay journal won't be recorded.");
+			return;
+		}
 
-		logger::info("{:>11} | {:^12} | {:^14} | {:^15} | {:^12} | {:^10} | {:^15} | {:^7} | {:^17} | {:^9} | {:^14} | {:^14}",
-			"Skill", "Grace Period", "Decay Duration", "Baseline Offset", "Extra Offset", "Difficulty", "Difficulty Mult", "Damping", "Legendary Damping", "Decay Cap", "Min Decay Days", "Max Decay Days");
-		for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
-			skillUsages[skill].Init(skill, configs[skill]);
-			const auto name = SkillName(skill);
-			logger::info("{:>11} | {:^12} | {:^14} | {:^15} | {:^12} | {:^10} | {:^15} | {:^7} | {:^17} | {:^9} | {:^14} | {:^14}",
-				name,
-				std::signbit(configs[skill].gracePeriod) ? "Auto" : std::format("{:.1f}h", configs[skill].gracePeriod),
-				std::format("{:.1f}h", configs[skill].interval),
-				configs[skill].baselineLevelOffset < 0 ? "Auto" : std::format("{}", configs[skill].baselineLevelOffset),
-				configs[skill].levelOffset,
-				configs[skill].difficultyOverride < 0 ? "Auto" : difficultyNames[configs[skill].difficultyOverride],
-				std::signbit(configs[skill].difficultyMult) ? "Auto" : std::format("{:.2f}", configs[skill].difficultyMult),
-				std::format("/{:.2f}", configs[skill].damping),
-				std::format("+{:.0f}%", (configs[skill].legendarySkillDamping - 1) * 100.0f),
-				configs[skill].levelCap == 0 ? "Base" : std::format("{}", configs[skill].levelCap),
-				std::format("{:.1f}d", configs[skill].minDaysPerLevel),
-				std::format("{:.1f}d", configs[skill].maxDaysPerLevel));
+		// Each session gets its own journal, named after the moment it started.
+		const auto now = std::chrono::system_clock::now();
+		const auto started = std::chrono::zoned_time(std::chrono::current_zone(), std::chrono::floor<std::chrono::seconds>(now));
+		*path /= Version::PROJECT;
+		*path /= std::format("Journal {:%Y-%m-%d %H-%M-%S}.journal", started);
+
+		std::error_code error;
+		std::filesystem::create_directories(path->parent_path(), error);
+		if (journal.Open(*path, std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count())) {
+			logger::info("Recording decay journal to {}", path->string());
+		} else {
+			logger::error("Failed to create decay journal {}", path->string());
 		}
 	}
 
-	void DecayTracker::ApplyTint(RE::GFxMovieView* movie) const
+	void DecayTracker::InitSkills()
 	{
+		const auto& options = optionsCache.Get();
 		for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
-			const auto& usage = skillUsages[skill];
-			const auto& config = usage.GetConfig();
-			if (usage.IsDecaying()) {
-				//auto r = config.decayTint.colorData.channels.red;
-				//auto g = config.decayTint.colorData.channels.green;
-				//auto b = config.decayTint.colorData.channels.blue;
-				//auto a = config.decayTint.colorData.channels.alpha;
-				//logger::info("Applying tint to {}:", SkillName(skill));
-				//logger::info("    RGBA: ({}, {}, {}, {})", r, g, b, a);
-
-				if (config.decayTint.colorData.channels.alpha > 0) {
-					for (const auto& path : config.uiLayers) {
-						movie->SetColorTint(path.c_str(), config.decayTint);
-						//if (movie->SetColorTint(path.c_str(), config.decayTint)) {
-						//	logger::info("    Layer: {}", path);
-						//} else {
-						//	logger::warn("    Failed to apply tint to layer: {}", path);
-						//}
-					}
-				}
-			} else if (config.normalTint.colorData.channels.alpha > 0) {
-				for (const auto& path : config.uiLayers) {
-					movie->SetColorTint(path.c_str(), config.normalTint);
-				}
-			}
+			skillStates[skill] = PlayerSkillState(skill);
+
+			DecayConfig decay = options.skills[skill];
+			const int   raceSkillBonus = ResolveRaceSkillBonus(skill, decay);
+			skillUsages[skill].Init(decay, Settings::iAVDSkillStart(), raceSkillBonus);
+
+			// Thresholds are built up front rather than on the first decay, since grace periods and decay rates are read long before that.
+			skillUsages[skill].UpdateThresholds(skillStates[skill]);
 		}
+
+		// Configs or race skill bonuses might've changed grace periods, so all deadlines must be recalculated.
+		updater.ResetSchedule();
 	}
 
-	RE::BSEventNotifyControl DecayTracker::ProcessEvent(const RE::MenuOpenCloseEvent* event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*)
+	void DecayTracker::PublishTintState()
 	{
-		// We need to reload settings, specifically, Racial Skill Bonuses after RaceMenu is closed, since player might've changed race.
-		if (event->menuName == RE::RaceSexMenu::MENU_NAME && !event->opening) {
-			LoadSettings();
-		}
+		tintState.Store({ .decayingSkills = static_cast<std::uint32_t>(updater.GetDecaying().to_ulong()),
+			.configsRevision = tintConfigsRevision,
+			.configs = publishedTintConfigs.empty() ? nullptr : publishedTintConfigs.back().configs.get() });
+	}
 
-		return RE::BSEventNotifyControl::kContinue;
+	void DecayTracker::RetireTintConfigs()
+	{
+		// The UI thread only ever switches to the latest configs it sees, so it never goes back to the ones before those that it uses.
+		const auto inUse = tintConfigsInUse.load(std::memory_order_acquire);
+		std::erase_if(publishedTintConfigs, [inUse](const auto& published) { return published.revision < inUse; });
 	}
 
-	void DecayTracker::UpdateSkillUsage(RE::Calendar* calendar)
+	void DecayTracker::ApplyTint(RE::GFxMovieView* movie)
 	{
-		const std::string timestamp = std::format("{} {:.0f}:{}", calendar->GetDayName(), calendar->GetHour(), calendar->GetMinutes());
+		const auto                       state = tintState.Load();
+		const std::bitset<Skill::kTotal> decaying(state.decayingSkills);
+
+		const bool isStale = isTintCacheStale.load(std::memory_order_relaxed) && isTintCacheStale.exchange(false);
+
+		std::bitset<Skill::kTotal> changed;
+		if (isStale || movie != tintCache.movie || state.configsRevision != tintCache.configsRevision) {
+			// Published configs stay alive until the main thread sees that we've switched to later ones.
+			tintCache.configs = state.configs;
+			tintCache.configsRevision = state.configsRevision;
+			tintConfigsInUse.store(state.configsRevision, std::memory_order_release);
+			if (!tintCache.configs) {
+				return;
+			}
+			ResolveTintLayers(movie);
+			changed.set();
+		} else {
+			changed = tintCache.decaying ^ decaying;
+		}
 
-		if (logSkillUsage) {
-			logger::info("{:*^65}", " Skill Data ");
-			logger::info("[{:^13}] {} | {:^11} | {:^11} | {:^9} | {:^8}", timestamp, "D", "Skill", "Level [Cap]", "Threshold", "XP");
+		if (changed.none()) {
+			return;
 		}
 
 		for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
-			auto&       usage = skillUsages[skill];
-			const auto& skillData = Player->skills->data->skills[skill];
-
-			std::string decayStatus = "-";
-
-			if (!usage.IsInitialized() || usage.WasUsed()) {
-				usage.SetUsed(calendar);
-				decayStatus = "↑";
-			} else if (usage.IsDecaying()) {
-				usage.Decay(calendar);
-				decayStatus = "↓";
-			} else if (usage.IsStale(calendar)) {
-				usage.MarkDecaying(calendar);
-				decayStatus = "-";
-			}
-			if (logSkillUsage) {
-				std::string levelInfo = std::format("{:^3.0f}[{:^2}]", Player->GetBaseActorValue(AV(skill)), usage.GetDecayCapLevel());
-				logger::info("[{:^13}] {} | {:^11} | {:^11} | {:^9.2f} | {:^8.2f}", timestamp, decayStatus, SkillName(skill), levelInfo, skillData.levelThreshold, skillData.xp);
+			if (changed[skill]) {
+				ApplyTint(skill, decaying[skill]);
 			}
 		}
-		if (logSkillUsage) {
-			logger::info("");
-		}
+		tintCache.decaying = decaying;
 	}
-}
-
-// Serialization
-namespace Decay
-{
 
-	namespace details
+	void DecayTracker::ResolveTintLayers(RE::GFxMovieView* movie)
 	{
-		template <typename T>
-		bool Write(SKSE::SerializationInterface* a_interface, const T& data)
-		{
-			return a_interface->WriteRecordData(&data, sizeof(T));
+		tintCache.movie = movie;
+		for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
+			auto& layers = tintCache.layers[skill];
+			layers.clear();
+			for (const auto& path : (*tintCache.configs)[skill].uiLayers) {
+				RE::GFxValue layer;
+				if (movie->GetVariable(&layer, path.c_str()) && layer.IsDisplayObject()) {
+					layers.push_back(std::move(layer));
+				} else {
+					logger::warn("UI layer {} of {} was not found in StatsMenu", path, SkillName(skill));
+				}
+			}
 		}
+	}
 
-		template <>
-		bool Write(SKSE::SerializationInterface* a_interface, const std::string& data)
-		{
-			const std::size_t size = data.length();
-			return a_interface->WriteRecordData(size) && a_interface->WriteRecordData(data.data(), static_cast<std::uint32_t>(size));
+	/// Color transform that tints a display object with the color, blending it in by the color's alpha, as Flash tints do:
+	/// each color channel is scaled by (1 - alpha) and offset by the tint's channel times alpha. Opacity of the object is kept.
+	RE::GRenderer::Cxform MakeTint(const RE::GColor& color)
+	{
+		// Rows of the matrix are red, green, blue and alpha channels, columns are multipliers and offsets.
+		constexpr std::size_t mult = 0;
+		constexpr std::size_t add = 1;
+
+		const auto& channels = color.colorData.channels;
+		const float amount = channels.alpha / 255.0f;
+		const float tint[] = { channels.red, channels.green, channels.blue };
+
+		RE::GRenderer::Cxform cxform;
+		for (std::size_t channel = 0; channel < std::size(tint); ++channel) {
+			cxform.matrix[channel][mult] = 1.0f - amount;
+			cxform.matrix[channel][add] = tint[channel] * amount;
 		}
+		cxform.matrix[3][mult] = 1.0f;
+		cxform.matrix[3][add] = 0.0f;
+		return cxform;
+	}
 
-		template <typename T>
-		bool Read(SKSE::SerializationInterface* a_interface, T& result)
-		{
-			return a_interface->ReadRecordData(&result, sizeof(T));
-		}
+	void DecayTracker::ApplyTint(Skill skill, bool isDecaying)
+	{
+		const auto& config = (*tintCache.configs)[skill];
+		const auto& tint = isDecaying ? config.decayTint : config.normalTint;
 
-		template <>
-		bool Read(SKSE::SerializationInterface* a_interface, std::string& result)
-		{
-			std::size_t size = 0;
-			if (!a_interface->ReadRecordData(size)) {
-				return false;
-			}
-			if (size > 0) {
-				result.resize(size);
-				if (!a_interface->ReadRecordData(result.data(), static_cast<std::uint32_t>(size))) {
-					return false;
-				}
-			} else {
-				result = "";
+		if (tint.colorData.channels.alpha > 0) {
+			const auto cxform = MakeTint(tint);
+			for (auto& layer : tintCache.layers[skill]) {
+				layer.SetCxform(cxform);
 			}
-			return true;
 		}
 	}
 
-	constexpr std::uint32_t serializationKey = 'SKDC';
-	constexpr std::uint32_t skillUsageRecordType = 'SKUS';
-	constexpr std::uint32_t skillUsageVersion = 1;
+	void DecayTracker::ReleaseTint()
+	{
+		for (auto& layers : tintCache.layers) {
+			layers.clear();
+		}
+		tintCache.movie = nullptr;
+	}
 
-	bool Write(SKSE::SerializationInterface* a_interface, const SkillUsage& skill)
+	RE::BSEventNotifyControl DecayTracker::ProcessEvent(const RE::MenuOpenCloseEvent* event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*)
 	{
-		if (!a_interface->OpenRecord(skillUsageRecordType, skillUsageVersion)) {
-			return false;
+		// We need to reload settings, specifically, Racial Skill Bonuses after RaceMenu is closed, since player might've changed race.
+		// The reload itself is deferred to the next AdvanceTime().
+		if (event->menuName == RE::RaceSexMenu::MENU_NAME && !event->opening) {
+			isReloadRequested = true;
 		}
 
-		return details::Write(a_interface, skill.daysPassedWhenLastUsed) &&
-		       details::Write(a_interface, skill.lastKnownLevel) &&
-		       details::Write(a_interface, skill.lastKnownXP) &&
-		       details::Write(a_interface, skill.lastKnownLegendaryLevel) &&
-		       details::Write(a_interface, skill.lastKnownHighestLevel) &&
-		       details::Write(a_interface, skill.isDecaying) &&
-		       details::Write(a_interface, skill.daysPassedSinceLastDecay);
+		// StatsMenu's movie is reset each time the menu is opened, so all layers have to be resolved and tinted again.
+		// The cache itself belongs to the UI thread, so it is only flagged here.
+		if (event->menuName == RE::StatsMenu::MENU_NAME && event->opening) {
+			isTintCacheStale = true;
+		}
+
+		return RE::BSEventNotifyControl::kContinue;
 	}
 
-	bool Read(SKSE::SerializationInterface* a_interface, SkillUsage& skill)
+	void DecayTracker::UpdateSkillUsage(RE::Calendar* calendar, bool onlyDue)
 	{
-		return details::Read(a_interface, skill.daysPassedWhenLastUsed) &&
-		       details::Read(a_interface, skill.lastKnownLevel) &&
-		       details::Read(a_interface, skill.lastKnownXP) &&
-		       details::Read(a_interface, skill.lastKnownLegendaryLevel) &&
-		       details::Read(a_interface, skill.lastKnownHighestLevel) &&
-		       details::Read(a_interface, skill.isDecaying) &&
-		       details::Read(a_interface, skill.daysPassedSinceLastDecay);
+		if (Settings::Refresh()) {
+			logger::info("Game settings have changed. iAVDSkillStart: {}, fSkillUseCurve: {:.2f}", Settings::iAVDSkillStart(), Settings::fSkillUseCurve());
+			for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
+				skillUsages[skill].SetBaselineLevel(Settings::iAVDSkillStart());
+				skillUsages[skill].UpdateThresholds(skillStates[skill]);
+			}
+		}
+
+		const float daysPassed = calendar->GetDaysPassed();
+
+		const auto due = onlyDue ? updater.PopDue(daysPassed) : SkillUpdater::SkillSet().set();
+
+		// Skills are read from the Player once, and only the ones that have changed are written back after the update.
+		playerSnapshot.Capture(daysPassed, due);
+		const auto& clock = playerSnapshot.GetClock();
+
+		trace.ApplyConfiguration();
+		if (trace.IsEnabled()) {
+			trace.BeginTick(calendar);
+		}
+
+		const auto wasDecaying = updater.GetDecaying();
+		updater.Update(
+			due, clock,
+			[this](std::size_t skill) -> SkillState& { return playerSnapshot[static_cast<Skill>(skill)]; },
+			[&](std::size_t skillIndex, SkillEvent event) {
+				const auto  skill = static_cast<Skill>(skillIndex);
+				const auto  usage = skillUsages[skill];
+				const auto& state = playerSnapshot[skill];
+				DecayAPI::GetInstance().Record(skill, usage, state);
+
+				if (trace.IsEnabled()) {
+					trace.RecordSkill(skill, event, state.GetLevel(), usage.GetDecayCapLevel(state), state.GetProgress());
+				}
+				if (journal.IsOpen()) {
+					journal.RecordSkill(skillIndex, event, daysPassed, state.GetLevel(), usage.GetDecayCapLevel(state), state.GetProgress().xp);
+				}
+			});
+
+		playerSnapshot.Commit();
+
+		if (updater.GetDecaying() != wasDecaying) {
+			PublishTintState();
+		}
+
+		if (trace.IsEnabled()) {
+			trace.EndTick();
+		}
 	}
+}
+
+// Serialization
+namespace Decay
+{
 
 	void DecayTracker::Register()
 	{
@@ -382,26 +409,43 @@ namespace Decay
 		logger::info("{:*^30}", " LOADING ");
 
 		std::uint32_t type, version, length;
-		Skill         skill = Skill::kOneHanded;
 
 		auto& tracker = GetInstance();
-		tracker.lastDaysPassed = 0.0f;
-
-		while (skill < Skill::kTotal && interface->GetNextRecordInfo(type, version, length)) {
-			if (type == skillUsageRecordType) {
-				switch (version) {
-				case 1:
-					if (Read(interface, tracker[skill])) {
-						logger::info("Loaded usage for {}", SkillName(skill));
-					} else {
-						logger::error("Failed to load usage for {}. SkillUsage will be reset.", SkillName(skill));
-					}
-					break;
-				default:
-					logger::error("Unsupported SkillUsage version: {} for {}. SkillUsage will be reset.", version, SkillName(skill));
-					break;
+		tracker.updater.ResetSchedule();
+
+		SkillUsageLoader loader(tracker.skillUsages);
+
+		while (interface->GetNextRecordInfo(type, version, length)) {
+			if (type != skillUsageRecordType) {
+				continue;
+			}
+
+			const auto legacySkill = static_cast<Skill>(loader.GetNextLegacySkill());
+			switch (loader.Load(interface, version, length)) {
+			case SkillUsageLoader::Result::kUnexpected:
+				logger::warn("Ignoring unexpected SkillUsage record");
+				break;
+			case SkillUsageLoader::Result::kFailed:
+				if (version == 1) {
+					logger::error("Failed to load usage for {}. SkillUsage will be reset.", SkillName(legacySkill));
+				} else {
+					logger::error("Failed to load usage of skills. SkillUsage will be reset.");
 				}
-				Inc(skill);
+				break;
+			case SkillUsageLoader::Result::kUnsupported:
+				logger::error("Unsupported SkillUsage version: {}. SkillUsage will be reset.", version);
+				break;
+			default:
+				break;
+			}
+		}
+
+		const auto& loaded = loader.GetLoaded();
+		for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
+			if (loaded[skill]) {
+				logger::info("Loaded usage for {}", SkillName(skill));
+			} else {
+				logger::info("No saved usage for {}. It will start being tracked from now on.", SkillName(skill));
 			}
 		}
 	}
@@ -416,22 +460,30 @@ namespace Decay
 		// This avoid situations when player gains XP or levels up a skill and immediately saves. This would
 		tracker.UpdateSkillUsage(RE::Calendar::GetSingleton());
 
-		for (Skill skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
-			if (interface->OpenRecord(skillUsageRecordType, skillUsageVersion)) {
-				if (Write(interface, tracker[skill])) {
-					logger::info("Saved usage for {}", SkillName(skill));
-				} else {
-					logger::error("Failed to save usage for {}", SkillName(skill));
-				}
-			}
+		if (interface->OpenRecord(skillUsageRecordType, skillUsageVersion) && Write(interface, tracker.skillUsages)) {
+			logger::info("Saved usage for all skills");
+		} else {
+			logger::error("Failed to save usage of skills");
 		}
+
+		// Journal is written out on each save, so that it covers everything that's been saved even if the game crashes later.
+		if (tracker.journal.IsOpen() && !tracker.journal.Flush()) {
+			logger::error("Failed to write decay journal. It won't be recorded for the rest of the session.");
+		}
+
+		HookProfiler::Dump();
 	}
 
 	void DecayTracker::Revert(SKSE::SerializationInterface*)
 	{
 		logger::info("{:*^30}", " REVERTING ");
-		GetInstance().lastDaysPassed = 0.0f;
 		auto& tracker = GetInstance();
+		tracker.updater.ResetSchedule();
+		tracker.updater.ResetDecaying();
+		tracker.PublishTintState();
+		if (tracker.journal.IsOpen()) {
+			tracker.journal.RecordReset(RE::Calendar::GetSingleton()->GetDaysPassed());
+		}
 		for (Skill skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
 			tracker[skill].Revert();
 			logger::info("Reverted usage for {}", SkillName(skill));
@@ -1,9 +1,21 @@
 #pragma once
-#include "SkillUsage.h"
+#include "Decay/Journal.h"
+#include "Decay/SkillUpdater.h"
+#include "Decay/SkillUsage.h"
+#include "DecayOptions.h"
+#include "GameState.h"
+#include "SeqLock.h"
+#include "SkillTrace.h"
 
 namespace Decay
 {
+	static_assert(Skill::kTotal == skillCount);
 
+	/// Tracks usage of Player's skills and decays them.
+	///
+	/// All state is owned by the game's main thread: AdvanceTime(), SkillUsed(), settings and serialization callbacks all run there.
+	/// StatsMenu is updated on the UI thread, so ApplyTint() only ever reads state that the main thread publishes for it,
+	/// and neither side waits for the other.
 	class DecayTracker : public RE::BSTEventSink<RE::MenuOpenCloseEvent>
 	{
 	public:
@@ -14,35 +26,128 @@ namespace Decay
 		}
 		static void Register();
 
-		SkillUsage&       operator[](Skill skill) { return skillUsages[skill]; }
-		SkillUsage const& operator[](Skill skill) const { return skillUsages[skill]; }
+		SkillUsage       operator[](Skill skill) { return skillUsages[skill]; }
+		ConstSkillUsage  operator[](Skill skill) const { return skillUsages[skill]; }
 
 		void AdvanceTime(RE::Calendar* calendar);
+
+		/// Marks given skill as used at the current moment.
+		/// Called whenever Player gains XP in a skill.
+		void SkillUsed(RE::ActorValue av);
 		void LoadSettings();
 
-		bool IsDecaying() const
-		{
-			for (const auto& usage : skillUsages) {
-				if (usage.IsDecaying()) {
-					return true;
-				}
-			}
-			return false;
-		}
+		bool IsDecaying() const { return updater.GetDecaying().any(); }
+
+		/// Applies tints to skill meters in StatsMenu. Called on the UI thread.
+		/// Tints are only re-applied to skills whose decaying state has changed since the last call, or when the menu is re-opened.
+		void ApplyTint(RE::GFxMovieView*);
 
-		void ApplyTint(RE::GFxMovieView*) const;
+		/// Releases display objects of StatsMenu that tints are applied through. Called on the UI thread when the menu is hidden,
+		/// since they hold references into its movie, which is destroyed with the menu.
+		void ReleaseTint();
 
 	protected:
 		RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override;
 
 	private:
-		/// Hours between SkillUsage updates.
-		float      trackingRate = 0.016f;  // once every in-game minute by default
-		bool       logSkillUsage = false;
-		float      lastDaysPassed;
-		SkillUsage skillUsages[Skill::kTotal];
+		SkillUsageTable  skillUsages;
+		SkillUpdater     updater{ skillUsages };  // Schedules and runs updates of skillUsages.
+		PlayerSkillState skillStates[Skill::kTotal];
+		PlayerSnapshot   playerSnapshot;  // Player's skills as of the current update.
+		SkillTrace       trace;
+
+		/// Journal of the current session. Only open when recordJournal option is enabled.
+		JournalWriter journal;
+
+		/// Days passed as of the last tick recorded to the journal.
+		float journalDaysPassed = 0.0f;
+
+		/// Opens the journal of the current session if it is enabled and not open yet, or closes it otherwise.
+		void ConfigureJournal(bool isEnabled);
+
+		/// Options parsed from SkillDecay.ini, which are re-parsed only when the file changes.
+		DecayOptionsCache optionsCache{ R"(Data\SKSE\Plugins\SkillDecay.ini)" };
+
+		/// Parses SkillDecay.ini in the background whenever it changes while the game is running.
+		DecayOptionsWatcher optionsWatcher;
+
+		/// Set when settings need to be reloaded on the next AdvanceTime().
+		std::atomic<bool> isReloadRequested = false;
+
+		/// Applies options that the watcher has published, if any.
+		void ReloadOptions();
+
+		/// Applies current options that don't depend on Player.
+		void ApplyOptions();
+
+		/// Initializes all skills with current options, resolving Player-dependent values.
+		void InitSkills();
+
+		using TintConfigs = std::array<TintConfig, Skill::kTotal>;
+
+		/// State that StatsMenu tints are derived from, published by the main thread whenever it changes.
+		struct TintState
+		{
+			/// Bit per skill that is currently decaying.
+			std::uint32_t decayingSkills = 0;
+
+			/// Incremented whenever new tint configs are published.
+			std::uint32_t configsRevision = 0;
+
+			/// The latest tint configs of all skills, owned by publishedTintConfigs.
+			const TintConfigs* configs = nullptr;
+		};
+		SeqLock<TintState> tintState;
+
+		struct PublishedTintConfigs
+		{
+			std::uint32_t                      revision;
+			std::unique_ptr<const TintConfigs> configs;
+		};
+
+		/// Tint configs that the UI thread might still be using, oldest first. Only accessed on the main thread.
+		/// They are immutable once published and only replaced when options are applied.
+		std::vector<PublishedTintConfigs> publishedTintConfigs;
+		std::uint32_t                     tintConfigsRevision = 0;
+
+		/// Revision of tint configs that the UI thread has switched to. Configs of earlier revisions are no longer used by it and can be freed.
+		std::atomic<std::uint32_t> tintConfigsInUse = 0;
+
+		/// Frees published tint configs that the UI thread no longer uses.
+		void RetireTintConfigs();
+
+		/// Set when StatsMenu is opened, since its movie is reset and layers have to be resolved again.
+		std::atomic<bool> isTintCacheStale = false;
+
+		/// Publishes decaying state of the skills and the revision of tint configs for the UI thread.
+		void PublishTintState();
+
+		/// State of skill meters' tint in StatsMenu. Only accessed on the UI thread.
+		struct TintCache
+		{
+			/// Movie that layers were resolved in. nullptr means that layers must be resolved again.
+			RE::GFxMovieView* movie = nullptr;
+
+			/// Configs that layers were resolved with.
+			const TintConfigs* configs = nullptr;
+			std::uint32_t      configsRevision = 0;
+
+			/// Display objects of the skill's uiLayers that exist in the movie.
+			/// Tints are applied directly through them, so paths are only looked up once per movie.
+			std::vector<RE::GFxValue> layers[Skill::kTotal];
+
+			/// Decaying state of the skills that tints are currently applied for.
+			std::bitset<Skill::kTotal> decaying;
+		} tintCache;
+
+		/// Resolves uiLayers of all skills in the movie and caches the ones that exist.
+		void ResolveTintLayers(RE::GFxMovieView*);
+
+		void ApplyTint(Skill, bool isDecaying);
 
-		void UpdateSkillUsage(RE::Calendar*);
+		/// Updates skill usages.
+		/// When onlyDue is set, only skills with passed deadline in the updater's schedule are updated.
+		void UpdateSkillUsage(RE::Calendar*, bool onlyDue = false);
 
 		static void Load(SKSE::SerializationInterface*);
 		static void Save(SKSE::SerializationInterface*);
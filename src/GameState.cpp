@@ -0,0 +1,107 @@
+#include "GameState.h"
+#include "Options.h"
+#include "RE/A/ActorValueList.h"
+#include "RE/P/PlayerCharacter.h"
+
+namespace Decay
+{
+	PlayerSkillState::PlayerSkillState(Skill skill) :
+		skill(skill),
+		skillInfo(RE::ActorValueList::GetActorValueInfo(AV(skill)))
+	{}
+
+	SkillProgress PlayerSkillState::GetProgress() const
+	{
+		const auto& skillData = Player->skills->data->skills[skill];
+		return { skillData.level, skillData.xp, skillData.levelThreshold };
+	}
+
+	void PlayerSkillState::SetProgress(const SkillProgress& progress)
+	{
+		auto& skillData = Player->skills->data->skills[skill];
+		skillData.level = progress.level;
+		skillData.xp = progress.xp;
+		skillData.levelThreshold = progress.levelThreshold;
+	}
+
+	LevelingParams PlayerSkillState::GetLeveling() const
+	{
+		if (!skillInfo || !skillInfo->skill) {
+			return {};
+		}
+
+		return { skillInfo->skill->improveMult, skillInfo->skill->improveOffset, Settings::fSkillUseCurve() };
+	}
+
+	void PlayerSnapshot::Capture(float daysPassed, const std::bitset<Skill::kTotal>& a_skills)
+	{
+		player = Player;
+		clock = SnapshotClock(daysPassed);
+		captured = a_skills;
+
+		const auto& skillData = player->skills->data;
+		const int   difficulty = player->difficulty;
+		const float curve = Settings::fSkillUseCurve();
+
+		for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
+			if (!captured[skill]) {
+				continue;
+			}
+
+			auto& info = skillInfos[skill];
+			if (!info) {
+				info = RE::ActorValueList::GetActorValueInfo(AV(skill));
+			}
+			const LevelingParams leveling = info && info->skill ? LevelingParams{ info->skill->improveMult, info->skill->improveOffset, curve } : LevelingParams{};
+
+			const auto& data = skillData->skills[skill];
+			skills[skill].Capture(
+				player->GetBaseActorValue(AV(skill)),
+				{ data.level, data.xp, data.levelThreshold },
+				skillData->legendaryLevels[skill],
+				difficulty,
+				leveling);
+		}
+	}
+
+	void PlayerSnapshot::Commit()
+	{
+		for (auto skill = Skill::kOneHanded; skill < Skill::kTotal; Inc(skill)) {
+			if (!captured[skill]) {
+				continue;
+			}
+
+			const auto& snapshot = skills[skill];
+			if (const float delta = snapshot.GetLevelDelta(); delta != 0.0f) {
+				player->ModBaseActorValue(AV(skill), delta);
+			}
+			if (snapshot.IsProgressModified()) {
+				const auto progress = snapshot.GetProgress();
+				auto&      data = player->skills->data->skills[skill];
+				data.level = progress.level;
+				data.xp = progress.xp;
+				data.levelThreshold = progress.levelThreshold;
+			}
+		}
+		captured.reset();
+	}
+
+	int ResolveRaceSkillBonus(Skill skill, DecayConfig& config)
+	{
+		int raceSkillBonus = 0;
+
+		for (const auto& boost : Player->GetRace()->data.skillBoosts) {
+			const auto skillIndex = boost.skill.underlying() - 6;
+			if (skillIndex >= 0 && skillIndex < Skill::kTotal) {
+				if (static_cast<Skill>(skillIndex) == skill && raceSkillBonus == 0) {
+					raceSkillBonus = boost.bonus;
+				}
+				if (config.baselineLevelOffset < 0 && boost.bonus > config.baselineLevelOffset) {
+					config.baselineLevelOffset = boost.bonus;
+				}
+			}
+		}
+
+		return raceSkillBonus;
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "Decay/DecayConfig.h"
+#include "Decay/SkillSnapshot.h"
+#include "Decay/SkillState.h"
+
+namespace Decay
+{
+	/// SkillState backed by the Player's skill.
+	class PlayerSkillState : public SkillState
+	{
+	public:
+		PlayerSkillState() = default;
+		explicit PlayerSkillState(Skill skill);
+
+		float GetLevel() const override { return Player->GetBaseActorValue(AV(skill)); }
+		void  ModLevel(float delta) override { Player->ModBaseActorValue(AV(skill), delta); }
+
+		SkillProgress GetProgress() const override;
+		void          SetProgress(const SkillProgress& progress) override;
+
+		int GetLegendaryLevel() const override { return Player->skills->data->legendaryLevels[skill]; }
+		int GetDifficulty() const override { return Player->difficulty; }
+
+		LevelingParams GetLeveling() const override;
+
+	private:
+		Skill skill = Skill::kTotal;
+
+		/// Cached info of the skill's Actor Value, which holds skill's leveling parameters.
+		RE::ActorValueInfo* skillInfo = nullptr;
+	};
+
+	/// Clock backed by the game's Calendar.
+	class CalendarClock : public Clock
+	{
+	public:
+		explicit CalendarClock(const RE::Calendar* calendar) :
+			calendar(calendar)
+		{}
+
+		float GetDaysPassed() const override { return calendar->GetDaysPassed(); }
+
+	private:
+		const RE::Calendar* calendar;
+	};
+
+	/// Player's skills read once at the start of DecayTracker's update.
+	///
+	/// Every access to the Player goes through PlayerCharacter::GetSingleton() and the skill's Actor Value,
+	/// so the update works on the snapshot instead and only skills that have actually changed are written back.
+	class PlayerSnapshot
+	{
+	public:
+		/// Reads given skills of the Player along with the game's difficulty.
+		void Capture(float daysPassed, const std::bitset<Skill::kTotal>& skills);
+
+		/// Writes back captured skills whose level or progress have changed.
+		void Commit();
+
+		SkillSnapshot& operator[](Skill skill) { return skills[skill]; }
+
+		const Clock& GetClock() const { return clock; }
+
+	private:
+		RE::PlayerCharacter*       player = nullptr;
+		SnapshotClock              clock;
+		SkillSnapshot              skills[Skill::kTotal];
+		std::bitset<Skill::kTotal> captured;
+
+		/// Cached info of the skills' Actor Values, which hold skills' leveling parameters.
+		RE::ActorValueInfo* skillInfos[Skill::kTotal]{};
+	};
+
+	/// Finds the bonus that Player's race provides to the skill.
+	/// If config uses automatic baselineLevelOffset it will be resolved based on the race's skill boosts as well.
+	int ResolveRaceSkillBonus(Skill skill, DecayConfig& config);
+}
@@ -0,0 +1,154 @@
+#include "HookProfiler.h"
+
+#ifdef PROFILE_HOOKS
+namespace Decay::HookProfiler
+{
+	namespace
+	{
+		struct Entry
+		{
+			std::string name;
+			Histogram*  histogram;
+		};
+
+		/// Hooks are only registered during installation, which happens before any of them can be called.
+		std::vector<Entry> entries;
+		std::mutex         dumpLock;
+
+		/// Thread that dumps histograms periodically, and the condition it waits on between dumps,
+		/// so that stopping it doesn't have to wait for the rest of the interval.
+		std::jthread                worker;
+		std::mutex                  workerLock;
+		std::condition_variable_any workerCondition;
+
+		/// Reference points used to convert TSC cycles to real time.
+		const std::uint64_t startCycles = __rdtsc();
+		const auto          startTime = std::chrono::steady_clock::now();
+
+		double GetCyclesPerMicrosecond()
+		{
+			const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+			return elapsed > 0 ? static_cast<double>(__rdtsc() - startCycles) / elapsed : 1.0;
+		}
+	}
+
+	void Histogram::Record(std::uint64_t cycles)
+	{
+		count.fetch_add(1, std::memory_order_relaxed);
+		total.fetch_add(cycles, std::memory_order_relaxed);
+		buckets[GetBucket(cycles)].fetch_add(1, std::memory_order_relaxed);
+
+		auto currentMax = max.load(std::memory_order_relaxed);
+		while (cycles > currentMax && !max.compare_exchange_weak(currentMax, cycles, std::memory_order_relaxed)) {}
+	}
+
+	Histogram::Summary Histogram::Summarize() const
+	{
+		Summary summary;
+		summary.count = count.load(std::memory_order_relaxed);
+		summary.max = max.load(std::memory_order_relaxed);
+		if (summary.count == 0) {
+			return summary;
+		}
+		summary.mean = static_cast<double>(total.load(std::memory_order_relaxed)) / summary.count;
+
+		// Count the samples from the top, so that the percentile stays close to the tail even if the buckets are mid-update.
+		const auto  tail = std::max<std::uint64_t>(1, summary.count / 100);
+		std::size_t seen = 0;
+		for (auto bucket = bucketCount; bucket-- > 0;) {
+			seen += buckets[bucket].load(std::memory_order_relaxed);
+			if (seen >= tail) {
+				summary.p99 = std::min(summary.max, GetBucketUpperBound(bucket));
+				break;
+			}
+		}
+		return summary;
+	}
+
+	std::size_t Histogram::GetBucket(std::uint64_t cycles)
+	{
+		if (cycles < (1ull << subBucketBits)) {
+			return static_cast<std::size_t>(cycles);
+		}
+		const auto exponent = static_cast<std::size_t>(std::bit_width(cycles) - 1);
+		const auto mantissa = static_cast<std::size_t>(cycles >> (exponent - subBucketBits)) & ((1 << subBucketBits) - 1);
+		return ((exponent - subBucketBits + 1) << subBucketBits) | mantissa;
+	}
+
+	std::uint64_t Histogram::GetBucketUpperBound(std::size_t bucket)
+	{
+		if (bucket < (1 << subBucketBits)) {
+			return bucket;
+		}
+		const auto exponent = (bucket >> subBucketBits) + subBucketBits - 1;
+		const auto mantissa = (bucket & ((1 << subBucketBits) - 1)) + 1;
+		return (((1ull << subBucketBits) + mantissa) << (exponent - subBucketBits)) - 1;
+	}
+
+	void Register(std::string_view name, Histogram& histogram)
+	{
+		std::scoped_lock lock(dumpLock);
+		entries.emplace_back(std::string(name), &histogram);
+	}
+
+	void Dump()
+	{
+		std::scoped_lock lock(dumpLock);
+		if (entries.empty()) {
+			return;
+		}
+
+		const auto perMicrosecond = GetCyclesPerMicrosecond();
+		logger::info("{:*^30}", " HOOK LATENCY ");
+		logger::info("{:>24} | {:^10} | {:^10} | {:^10} | {:^10}", "Hook", "Calls", "Mean", "p99", "Max");
+		for (const auto& [name, histogram] : entries) {
+			const auto summary = histogram->Summarize();
+			logger::info("{:>24} | {:^10} | {:^8.2f}us | {:^8.2f}us | {:^8.2f}us",
+				name,
+				summary.count,
+				summary.mean / perMicrosecond,
+				summary.p99 / perMicrosecond,
+				summary.max / perMicrosecond);
+		}
+		logger::info("");
+	}
+
+	void SetInterval(float seconds)
+	{
+		Stop();
+
+		if (seconds <= 0) {
+			return;
+		}
+
+		const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(seconds));
+		worker = std::jthread([interval](std::stop_token token) {
+			auto             nextDump = std::chrono::steady_clock::now() + interval;
+			std::unique_lock lock(workerLock);
+			// Nothing else notifies the condition, so the wait only ends at the deadline or when Stop() requests to stop.
+			while (!workerCondition.wait_until(lock, token, nextDump, [&token] { return token.stop_requested(); })) {
+				Dump();
+				nextDump += interval;
+			}
+		});
+	}
+
+	void Stop()
+	{
+		if (worker.joinable()) {
+			worker.request_stop();
+			worker.join();
+		}
+	}
+
+	void Shutdown()
+	{
+		// Windows terminates all other threads before it detaches DLLs from an exiting process,
+		// and joining a thread under the loader lock might deadlock, so the worker is only asked to stop and released.
+		if (worker.joinable()) {
+			worker.request_stop();
+			worker.detach();
+		}
+	}
+}
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+
+#ifdef PROFILE_HOOKS
+#	include <intrin.h>
+#endif
+
+/// Opt-in latency instrumentation of hook thunks.
+/// Enabled with PROFILE_HOOKS CMake option, otherwise thunks are installed as is and everything here compiles to nothing.
+namespace Decay::HookProfiler
+{
+#ifdef PROFILE_HOOKS
+	/// Lock-free latency histogram of a single hook, measured in TSC cycles.
+	/// Buckets are log-linear: each power of two is split into 4 sub-buckets, so percentiles are accurate to within 25%.
+	class Histogram
+	{
+	public:
+		struct Summary
+		{
+			std::uint64_t count = 0;
+			double        mean = 0;
+			std::uint64_t p99 = 0;
+			std::uint64_t max = 0;
+		};
+
+		void Record(std::uint64_t cycles);
+
+		/// Summarizes all samples recorded so far.
+		/// Samples that are recorded concurrently might only be partially accounted for.
+		Summary Summarize() const;
+
+	private:
+		static constexpr std::size_t subBucketBits = 2;
+		static constexpr std::size_t bucketCount = 64 << subBucketBits;
+
+		std::atomic<std::uint64_t>                          count = 0;
+		std::atomic<std::uint64_t>                          total = 0;
+		std::atomic<std::uint64_t>                          max = 0;
+		std::array<std::atomic<std::uint64_t>, bucketCount> buckets{};
+
+		static std::size_t   GetBucket(std::uint64_t cycles);
+		static std::uint64_t GetBucketUpperBound(std::size_t bucket);
+	};
+
+	/// Records cycles spent within its scope to the histogram.
+	class Timer
+	{
+	public:
+		explicit Timer(Histogram& histogram) :
+			histogram(histogram), start(__rdtsc()) {}
+
+		~Timer() { histogram.Record(__rdtsc() - start); }
+
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+
+	private:
+		Histogram&    histogram;
+		std::uint64_t start;
+	};
+
+	/// Adds the histogram to the ones that are logged by Dump().
+	/// Hooks are registered once when they are installed.
+	void Register(std::string_view name, Histogram& histogram);
+
+	/// Logs histograms of all registered hooks.
+	void Dump();
+
+	/// Dumps histograms every given number of real-time seconds from a background thread.
+	/// Zero or negative interval stops periodic dumps.
+	void SetInterval(float seconds);
+
+	/// Stops periodic dumps, waiting for the background thread to finish.
+	void Stop();
+
+	/// Releases the background thread when the plugin is detached from the process.
+	/// Unlike Stop(), never waits for the thread, since it's called while Windows holds the loader lock.
+	void Shutdown();
+#else
+	inline void Dump() {}
+	inline void SetInterval(float) {}
+	inline void Stop() {}
+	inline void Shutdown() {}
+#endif
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "HookProfiler.h"
 #include "SKSE/SKSE.h"
 
 #define ByteAt(addr) *reinterpret_cast<std::uint8_t*>(addr)
@@ -98,26 +99,125 @@ namespace details
 			Hook::func = func;
 		}
 	}
+
+	/// Name of the hook as it appears in logs.
+	/// Hooks that are generated for a call site (e.g. dispatch_hook) are named after the site.
+	template <typename Hook>
+	std::string_view get_name()
+	{
+		if constexpr (requires { typename Hook::site; }) {
+			return get_name<typename Hook::site>();
+		} else {
+			static const std::string name = [] {
+				std::string_view full = typeid(Hook).name();
+				if (const auto scope = full.rfind("::"); scope != std::string_view::npos) {
+					full.remove_prefix(scope + 2);
+				}
+				return std::string(full);
+			}();
+			return name;
+		}
+	}
+
+#ifdef PROFILE_HOOKS
+	/// Wraps Hook's thunk to record its latency, including the original function that it chains to.
+	template <typename Hook, typename Thunk = decltype(Hook::thunk)>
+	struct profiled_thunk;
+
+	template <typename Hook, typename R, typename... Args>
+	struct profiled_thunk<Hook, R(Args...)>
+	{
+		static inline Decay::HookProfiler::Histogram histogram;
+
+		static R thunk(Args... args)
+		{
+			const Decay::HookProfiler::Timer timer{ histogram };
+			return Hook::thunk(args...);
+		}
+	};
+#endif
+
+	/// Function that is written to the hook's site.
+	template <typename Hook>
+	constexpr auto get_thunk()
+	{
+#ifdef PROFILE_HOOKS
+		return &profiled_thunk<Hook>::thunk;
+#else
+		return &Hook::thunk;
+#endif
+	}
+
+	/// Number of trampoline bytes that installing the Hook consumes.
+	/// Each call or lea replacement takes a single 14-byte absolute jump, while vtable hooks don't use the trampoline at all.
+	template <typename Hook>
+	constexpr std::size_t get_trampoline_size()
+	{
+		if constexpr (call_hook<Hook>) {
+			return 14;
+		} else {
+			return 0;
+		}
+	}
+
+	/// Checks that the instruction at the address is either a call or a lea that write_thunk knows how to replace.
+	/// Returns the reason why the location is invalid, or an empty string when it is valid.
+	inline std::string_view validate_call_site(std::uintptr_t address)
+	{
+		auto opcode = ByteAt(address);
+		if (opcode == 0xE8) {  // CALL instruction
+			return {};
+		}
+
+		constexpr std::uint8_t rexw = 0x48;
+		if ((opcode & rexw) != rexw) {  // REX.W Must be present for a valid 64-bit address replacement.
+			return "lea instruction must use 64-bit register (first byte should be between 0x48 and 04F)"sv;
+		}
+
+		opcode = ByteAt(address + 1);
+		if (opcode != 0x8D) {  // LEA instruction
+			return "write_thunk can only be used for call or lea instructions"sv;
+		}
+		return {};
+	}
+
+	template <typename Hook>
+	void validate_hook()
+	{
+		using ThunkType = decltype(Hook::thunk);
+		if constexpr (chain_hook<Hook>) {
+			using FuncType = decltype(Hook::func);
+			static_assert(std::is_same_v<REL::Relocation<ThunkType>, FuncType>, "Mismatching type of thunk and func. 'Use static inline REL::Relocation<decltype(thunk)> func;' to always match the type.");
+		}
+		static_assert(call_hook<Hook> || vtable_hook<Hook>, "Unsupported hook type. Hook must target either call, lea or vtable");
+
+		if constexpr (call_hook<Hook>) {
+			const REL::Relocation<std::uintptr_t> rel{ Hook::relocation, Hook::offset };
+			if (const auto error = validate_call_site(rel.address()); !error.empty()) {
+				SKSE::stl::report_and_fail(std::format("Invalid hook location of {}: {}", typeid(Hook).name(), error));
+			}
+		}
+	}
 }
 
 namespace stl
 {
 	using namespace SKSE::stl;
 
+	/// Writes a call to the Hook's thunk at a_src.
+	/// Trampoline space must already be reserved, see install_hooks().
 	template <hook Hook>
 	void write_thunk_call(std::uintptr_t a_src)
 	{
 		auto& trampoline = SKSE::GetTrampoline();
-		SKSE::AllocTrampoline(14);
-
-		details::set_func<Hook>(trampoline.write_call<5>(a_src, Hook::thunk));
+		details::set_func<Hook>(trampoline.write_call<5>(a_src, details::get_thunk<Hook>()));
 	}
 
 	template <has_vtable F, typename Hook>
 	void write_vfunc()
 	{
 		REL::Relocation<std::uintptr_t> vtbl{ F::VTABLE[details::get_vtable<Hook>()] };
-		details::set_func<Hook>(vtbl.write_vfunc(Hook::index, Hook::thunk));
+		details::set_func<Hook>(vtbl.write_vfunc(Hook::index, details::get_thunk<Hook>()));
 	}
 
 	template <vtable_hook Hook>
@@ -132,73 +232,121 @@ namespace stl
 		const REL::Relocation<std::uintptr_t> rel{ Hook::relocation, Hook::offset };
 		std::uintptr_t                        sourceAddress = rel.address();
 
-		auto byteAddress = sourceAddress;
-		auto opcode = ByteAt(byteAddress);
+		if (const auto error = details::validate_call_site(sourceAddress); !error.empty()) {
+			stl::report_and_fail(std::format("Invalid hook location, {}", error));
+		}
 
-		if (opcode == 0xE8) {  // CALL instruction
+		if (ByteAt(sourceAddress) == 0xE8) {  // CALL instruction
 			write_thunk_call<Hook>(sourceAddress);
-		} else {
-			auto                   leaSize = 7;
-			constexpr std::uint8_t rexw = 0x48;
-			if ((opcode & rexw) != rexw) {  // REX.W Must be present for a valid 64-bit address replacement.
-				stl::report_and_fail("Invalid hook location, lea instruction must use 64-bit register (first byte should be between 0x48 and 04F)"sv);
+		} else {  // REX.W LEA instruction
+			auto leaSize = 7;
+			auto byteAddress = sourceAddress + 1;
+			auto op1 = ByteAt(++byteAddress);  // Get first operand byte.
+			auto opAddress = byteAddress;
+			// Store original displacement
+			std::int32_t disp = 0;
+			for (std::uint8_t i = 0; i < 4; ++i) {
+				disp |= ByteAt(++byteAddress) << (i * 8);
 			}
-			opcode = ByteAt(++byteAddress);
-
-			if (opcode == 0x8D) {                  // LEA instruction
-				auto op1 = ByteAt(++byteAddress);  // Get first operand byte.
-				auto opAddress = byteAddress;
-				// Store original displacement
-				std::int32_t disp = 0;
-				for (std::uint8_t i = 0; i < 4; ++i) {
-					disp |= ByteAt(++byteAddress) << (i * 8);
-				}
 
-				assert(disp != 0);
-				// write CALL on top of LEA
-				// This will fill new displacement
-				// 8D MM XX XX XX XX -> 8D E8 YY YY YY YY (where MM is the operand #1, XX is the old func, and YY is the new func)
-				write_thunk_call<Hook>(opAddress);
+			assert(disp != 0);
+			// write CALL on top of LEA
+			// This will fill new displacement
+			// 8D MM XX XX XX XX -> 8D E8 YY YY YY YY (where MM is the operand #1, XX is the old func, and YY is the new func)
+			write_thunk_call<Hook>(opAddress);
 
-				// Restore operand byte
-				// Since we overwrote first operand of lea we need to write it back
-				// 8D E8 YY YY YY YY -> 8D MM YY YY YY YY
-				REL::safe_write(opAddress, op1);
+			// Restore operand byte
+			// Since we overwrote first operand of lea we need to write it back
+			// 8D E8 YY YY YY YY -> 8D MM YY YY YY YY
+			REL::safe_write(opAddress, op1);
 
-				// Find original function and store it in the hook's func.
-				details::set_func<Hook>(sourceAddress + leaSize + disp);
-			} else {
-				stl::report_and_fail("Invalid hook location, write_thunk can only be used for call or lea instructions"sv);
-			}
+			// Find original function and store it in the hook's func.
+			details::set_func<Hook>(sourceAddress + leaSize + disp);
 		}
 	}
 
-	/// Installs given hook
+	/// Writes given hook, calling its pre_hook and post_hook around it.
+	/// Expects the hook to be validated and trampoline space to be reserved, so use install_hooks() instead.
 	template <hook Hook>
-	void install_hook()
+	void write_hook()
 	{
-		using ThunkType = decltype(Hook::thunk);
-		if constexpr (chain_hook<Hook>) {
-			using FuncType = decltype(Hook::func);
-			static_assert(std::is_same_v<REL::Relocation<ThunkType>, FuncType>, "Mismatching type of thunk and func. 'Use static inline REL::Relocation<decltype(thunk)> func;' to always match the type.");
-		}
-
 		if constexpr (pre_hook<Hook>) {
 			Hook::pre_hook();
 		}
 
 		if constexpr (call_hook<Hook>) {
 			stl::write_thunk<Hook>();
-		} else if constexpr (vtable_hook<Hook>) {
-			stl::write_vfunc<Hook>();
 		} else {
-			static_assert(false, "Unsupported hook type. Hook must target either call, lea or vtable");
+			stl::write_vfunc<Hook>();
 		}
 
 		if constexpr (post_hook<Hook>) {
 			Hook::post_hook();
 		}
+
+#ifdef PROFILE_HOOKS
+		Decay::HookProfiler::Register(details::get_name<Hook>(), details::profiled_thunk<Hook>::histogram);
+#endif
+	}
+
+	/// Installs given hooks in order.
+	/// Trampoline space for all of them is summed up at compile time and reserved once,
+	/// and every hook site is validated before any of them gets patched, so a bad site never leaves the game half-hooked.
+	template <hook... Hooks>
+	void install_hooks()
+	{
+		(details::validate_hook<Hooks>(), ...);
+
+		if constexpr (constexpr auto trampolineSize = (details::get_trampoline_size<Hooks>() + ... + 0); trampolineSize > 0) {
+			SKSE::AllocTrampoline(trampolineSize);
+		}
+
+		(write_hook<Hooks>(), ...);
 	}
+
+	/// Installs given hook
+	template <hook Hook>
+	void install_hook()
+	{
+		install_hooks<Hook>();
+	}
+
+	/// Statically known list of subscribers that are notified in order with the arguments of a hooked call.
+	/// Each subscriber must have a static notify function accepting these arguments.
+	template <typename... Subscribers>
+	struct dispatch_list
+	{
+		template <typename... Args>
+		static void notify(Args... args)
+		{
+			(Subscribers::notify(args...), ...);
+		}
+	};
+
+	template <typename Site, typename Signature, typename Subscribers>
+	struct dispatch_hook;
+
+	/// Call hook that lets several subscribers share a single thunk at the Site instead of stacking trampolines on top of each other.
+	/// Site provides relocation and offset of the call (and optionally pre_hook/post_hook), while Subscribers are notified after the original function returns.
+	template <typename Site, typename R, typename... Args, typename Subscribers>
+	struct dispatch_hook<Site, R(Args...), Subscribers> : Site
+	{
+		using site = Site;
+
+		static R thunk(Args... args)
+		{
+			if constexpr (std::is_void_v<R>) {
+				func(args...);
+				Subscribers::notify(args...);
+			} else {
+				R result = func(args...);
+				Subscribers::notify(args...);
+				return result;
+			}
+		}
+
+		static inline REL::Relocation<decltype(thunk)> func;
+	};
 }
 
 #undef ByteAt
@@ -12,6 +12,11 @@ namespace Decay
 
 		static RE::UI_MESSAGE_RESULTS thunk(RE::StatsMenu* menu, RE::UIMessage& msg)
 		{
+			// Cached tint layers reference the menu's movie, so they must be gone by the time it is destroyed.
+			if (msg.type == RE::UI_MESSAGE_TYPE::kHide) {
+				DecayTracker::GetInstance().ReleaseTint();
+			}
+
 			auto result = func(menu, msg);
 
 			if (msg.type == RE::UI_MESSAGE_TYPE::kUpdate) {
@@ -31,42 +36,64 @@ namespace Decay
 		static inline REL::Relocation<decltype(thunk)> func;
 	};
 
-	struct AdvanceTime_Main
+	/// Notifies DecayTracker about skill usage as soon as Player receives skill XP.
+	struct PlayerCharacter_UseSkill
 	{
-		static inline constexpr REL::ID     relocation = RELOCATION_ID(35565, 36564);
-		static inline constexpr std::size_t offset = OFFSET(0x24D, 0x266);
+		using Target = RE::PlayerCharacter;
+		static inline constexpr std::size_t index{ 0xF7 };
 
-		static void thunk(RE::Calendar* calendar, float deltaTime)
+		static void thunk(RE::PlayerCharacter* player, RE::ActorValue av, float points, RE::TESForm* source)
 		{
-			func(calendar, deltaTime);
-			DecayTracker::GetInstance().AdvanceTime(calendar);
+			func(player, av, points, source);
+
+			if (points > 0) {
+				DecayTracker::GetInstance().SkillUsed(av);
+			}
 		}
 
 		static inline void post_hook()
 		{
-			logger::info("\t\t🪝Installed AdvanceTime Main loop hook.");
+			logger::info("\t\t🪝Installed PlayerCharacter UseSkill hook.");
 		}
 
 		static inline REL::Relocation<decltype(thunk)> func;
 	};
 
-	struct AdvanceTime_FastTravel
+	/// Lets DecayTracker catch up with the time that passed in the Calendar.
+	struct DecayTracker_AdvanceTime
 	{
-		static inline constexpr REL::ID     relocation = RELOCATION_ID(39373, 40445);
-		static inline constexpr std::size_t offset = OFFSET(0x2B1, 0x282);
-
-		static void thunk(RE::Calendar* calendar, float deltaTime)
+		static void notify(RE::Calendar* calendar, float)
 		{
-			func(calendar, deltaTime);
 			DecayTracker::GetInstance().AdvanceTime(calendar);
 		}
+	};
+
+	/// Subscribers that are notified whenever game time advances, regardless of which call site advanced it.
+	using AdvanceTimeSubscribers = stl::dispatch_list<DecayTracker_AdvanceTime>;
+
+	template <typename Site>
+	using AdvanceTime = stl::dispatch_hook<Site, void(RE::Calendar*, float), AdvanceTimeSubscribers>;
+
+	struct AdvanceTime_Main
+	{
+		static inline constexpr REL::ID     relocation = RELOCATION_ID(35565, 36564);
+		static inline constexpr std::size_t offset = OFFSET(0x24D, 0x266);
 
 		static inline void post_hook()
 		{
-			logger::info("\t\t🪝Installed AdvanceTime Fast Travel hook.");
+			logger::info("\t\t🪝Installed AdvanceTime Main loop hook.");
 		}
+	};
 
-		static inline REL::Relocation<decltype(thunk)> func;
+	struct AdvanceTime_FastTravel
+	{
+		static inline constexpr REL::ID     relocation = RELOCATION_ID(39373, 40445);
+		static inline constexpr std::size_t offset = OFFSET(0x2B1, 0x282);
+
+		static inline void post_hook()
+		{
+			logger::info("\t\t🪝Installed AdvanceTime Fast Travel hook.");
+		}
 	};
 
 	struct AdvanceTime_Sleep
@@ -74,26 +101,19 @@ namespace Decay
 		static inline constexpr REL::ID     relocation = RELOCATION_ID(39410, 40485);
 		static inline constexpr std::size_t offset = OFFSET(0x78, 0x78);
 
-		static void thunk(RE::Calendar* calendar, float deltaTime)
-		{
-			func(calendar, deltaTime);
-			DecayTracker::GetInstance().AdvanceTime(calendar);
-		}
-
 		static inline void post_hook()
 		{
 			logger::info("\t\t🪝Installed AdvanceTime Sleep hook.");
 		}
-
-		static inline REL::Relocation<decltype(thunk)> func;
 	};
 
 	void Install()
 	{
-		stl::install_hook<AdvanceTime_Main>();
-		stl::install_hook<AdvanceTime_FastTravel>();
-		stl::install_hook<AdvanceTime_Sleep>();
-
-		stl::install_hook<StatsMenu_ProcessMessage>();
+		stl::install_hooks<
+			AdvanceTime<AdvanceTime_Main>,
+			AdvanceTime<AdvanceTime_FastTravel>,
+			AdvanceTime<AdvanceTime_Sleep>,
+			PlayerCharacter_UseSkill,
+			StatsMenu_ProcessMessage>();
 	}
 }
@@ -2,10 +2,22 @@
 
 namespace Decay::Settings
 {
+	namespace details
+	{
+		/// Game settings are resolved once after data is loaded and are read through these pointers afterwards.
+		/// This way we avoid hashed string lookups in GameSettingCollection on every access,
+		/// while still seeing any changes that other mods make to the values.
+		inline RE::Setting* iAVDSkillStart = nullptr;
+		inline RE::Setting* fSkillUseCurve = nullptr;
+
+		/// Values of the settings at the time of the last Refresh().
+		inline int   lastSkillStart = 15;
+		inline float lastSkillUseCurve = 1.95f;
+	}
+
 	inline int iAVDSkillStart()
 	{
-		auto settings = RE::GameSettingCollection::GetSingleton();
-		if (auto setting = settings->GetSetting("iAVDSkillStart")) {
+		if (auto setting = details::iAVDSkillStart) {
 			return setting->data.i;
 		}
 		return 15;
@@ -13,10 +25,43 @@ namespace Decay::Settings
 
 	inline float fSkillUseCurve()
 	{
-		auto settings = RE::GameSettingCollection::GetSingleton();
-		if (auto setting = settings->GetSetting("fSkillUseCurve")) {
+		if (auto setting = details::fSkillUseCurve) {
 			return setting->data.f;
 		}
 		return 1.95f;
 	}
+
+	/// Checks whether any of the settings changed since the last call, which is a couple of comparisons.
+	/// This is the change check for everything derived from these settings: DecayTracker calls it once per update,
+	/// and when it returns true, re-applies the baseline level to all skills and rebuilds their level thresholds.
+	inline bool Refresh()
+	{
+		const auto skillStart = iAVDSkillStart();
+		const auto skillUseCurve = fSkillUseCurve();
+
+		if (skillStart == details::lastSkillStart && skillUseCurve == details::lastSkillUseCurve) {
+			return false;
+		}
+
+		details::lastSkillStart = skillStart;
+		details::lastSkillUseCurve = skillUseCurve;
+		return true;
+	}
+
+	/// Resolves game settings used by Skill Decay. Must be called once game data is loaded.
+	inline void Resolve()
+	{
+		auto settings = RE::GameSettingCollection::GetSingleton();
+		details::iAVDSkillStart = settings->GetSetting("iAVDSkillStart");
+		details::fSkillUseCurve = settings->GetSetting("fSkillUseCurve");
+
+		if (!details::iAVDSkillStart) {
+			logger::warn("iAVDSkillStart game setting not found. Default value of {} will be used.", iAVDSkillStart());
+		}
+		if (!details::fSkillUseCurve) {
+			logger::warn("fSkillUseCurve game setting not found. Default value of {} will be used.", fSkillUseCurve());
+		}
+
+		Refresh();
+	}
 }
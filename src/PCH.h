@@ -22,6 +22,12 @@ using namespace std::literals;
 using SkillData = RE::PlayerCharacter::PlayerSkills::Data::SkillData;
 using Skill = RE::PlayerCharacter::PlayerSkills::Data::Skill;
 
+/// Advances to the next skill, for iterating over all skills from Skill::kOneHanded up to Skill::kTotal.
+constexpr void Inc(Skill& skill)
+{
+	skill = static_cast<Skill>(static_cast<std::underlying_type_t<Skill>>(skill) + 1);
+}
+
 #define Player RE::PlayerCharacter::GetSingleton()
 #define AV(skill) static_cast<RE::ActorValue>(skill + 6)
 #define SkillName(skill) RE::ActorValueList::GetActorValueName(AV(skill))
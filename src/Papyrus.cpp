@@ -0,0 +1,60 @@
+#include "Papyrus.h"
+#include "DecayAPI.h"
+
+namespace Decay::Papyrus
+{
+	namespace
+	{
+		/// Builds an array of a single field of all skills from the latest published state.
+		template <typename T, typename Fn>
+		std::vector<T> Collect(Fn&& field)
+		{
+			const auto state = SkillDecayAPI::Read(*DecayAPI::GetInstance().GetStateBlock());
+
+			std::vector<T> values;
+			values.reserve(SkillDecayAPI::skillCount);
+			for (const auto& skill : state.skills) {
+				values.push_back(field(state, skill));
+			}
+			return values;
+		}
+
+		std::vector<float> GetHoursUntilDecay(RE::StaticFunctionTag*)
+		{
+			// State is only re-published when skills change, so grace periods are counted down to the current time.
+			const auto calendar = RE::Calendar::GetSingleton();
+			return Collect<float>([&](const SkillDecayAPI::DecayState& state, const SkillDecayAPI::SkillInfo& skill) {
+				const float hoursSincePublished = calendar ? (calendar->GetDaysPassed() - state.daysPassed) * 24.0f : 0.0f;
+				return std::max(0.0f, skill.hoursUntilDecay - hoursSincePublished);
+			});
+		}
+
+		std::vector<bool> GetDecayingSkills(RE::StaticFunctionTag*)
+		{
+			return Collect<bool>([](const auto&, const SkillDecayAPI::SkillInfo& skill) { return skill.isDecaying != 0; });
+		}
+
+		std::vector<std::int32_t> GetDecayCapLevels(RE::StaticFunctionTag*)
+		{
+			return Collect<std::int32_t>([](const auto&, const SkillDecayAPI::SkillInfo& skill) { return skill.capLevel; });
+		}
+
+		std::vector<float> GetDaysPerLevel(RE::StaticFunctionTag*)
+		{
+			// Papyrus has no infinity, so skills that never decay are reported with -1.
+			return Collect<float>([](const auto&, const SkillDecayAPI::SkillInfo& skill) { return std::isfinite(skill.daysPerLevel) ? skill.daysPerLevel : -1.0f; });
+		}
+	}
+
+	bool Register(RE::BSScript::IVirtualMachine* vm)
+	{
+		// Functions only read the published state, so they are safe to call from any VM thread without waiting for the game thread.
+		vm->RegisterFunction("GetHoursUntilDecay"sv, className, GetHoursUntilDecay, true);
+		vm->RegisterFunction("GetDecayingSkills"sv, className, GetDecayingSkills, true);
+		vm->RegisterFunction("GetDecayCapLevels"sv, className, GetDecayCapLevels, true);
+		vm->RegisterFunction("GetDaysPerLevel"sv, className, GetDaysPerLevel, true);
+
+		logger::info("Registered {} native functions", className);
+		return true;
+	}
+}
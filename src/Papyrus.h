@@ -0,0 +1,12 @@
+#pragma once
+
+/// Native functions of SkillDecay script.
+///
+/// Each function returns a value for all skills at once, so that scripts (e.g. MCM menus) need a single VM call per field instead of one per skill.
+/// Values are read lock-free from the state that DecayAPI publishes once per frame, so functions don't need to run on the game thread.
+namespace Decay::Papyrus
+{
+	constexpr auto className = "SkillDecay"sv;
+
+	bool Register(RE::BSScript::IVirtualMachine* vm);
+}
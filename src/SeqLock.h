@@ -0,0 +1,31 @@
+#pragma once
+#include "SkillDecayAPI.h"
+
+namespace Decay
+{
+	/// Shares a value of type T between a single writer thread and any number of reader threads.
+	///
+	/// This is the same seqlock that SkillDecayAPI publishes DecayState through, for state that is only shared within the plugin.
+	/// Store() must only ever be called from one thread at a time.
+	template <typename T>
+	class SeqLock
+	{
+	public:
+		SeqLock() { Store(T{}); }
+		explicit SeqLock(const T& value) { Store(value); }
+
+		SeqLock(const SeqLock&) = delete;
+		SeqLock& operator=(const SeqLock&) = delete;
+
+		void Store(const T& value) { SkillDecayAPI::Write(block, value); }
+
+		/// Copies the value if no write happened meanwhile. Never blocks.
+		bool TryLoad(T& value) const { return SkillDecayAPI::TryRead(block, value); }
+
+		/// Copies the value, retrying while the writer is storing a new one.
+		T Load() const { return SkillDecayAPI::Read(block); }
+
+	private:
+		SkillDecayAPI::SeqLockBlock<T> block;
+	};
+}
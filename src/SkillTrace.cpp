@@ -0,0 +1,216 @@
+#include "SkillTrace.h"
+
+namespace Decay
+{
+	SkillTrace::~SkillTrace()
+	{
+		StopWorker();
+	}
+
+	void SkillTrace::Configure(Mode a_mode, bool a_async)
+	{
+		requestedConfig.store(static_cast<std::uint8_t>(std::to_underlying(a_mode) << 1 | (a_async ? 1 : 0)), std::memory_order_relaxed);
+		isConfigRequested.store(true, std::memory_order_release);
+	}
+
+	void SkillTrace::ApplyConfiguration()
+	{
+		if (!isConfigRequested.load(std::memory_order_relaxed) || !isConfigRequested.exchange(false, std::memory_order_acquire)) {
+			return;
+		}
+
+		// Worker reads the mode while formatting, so it must not be running while we change it.
+		StopWorker();
+
+		const auto config = requestedConfig.load(std::memory_order_relaxed);
+		mode = static_cast<Mode>(config >> 1);
+		async = config & 1;
+
+		if (async && mode != Mode::kOff) {
+			StartWorker();
+		}
+	}
+
+	void SkillTrace::BeginTick(const RE::Calendar* calendar)
+	{
+		SkillTraceRecord record{};
+		record.type = SkillTraceRecord::Type::kTick;
+		record.hour = calendar->GetHour();
+		record.minutes = calendar->GetMinutes();
+
+		const auto dayName = calendar->GetDayName();
+		std::ranges::copy_n(dayName.begin(), std::min(dayName.size(), sizeof(record.dayName) - 1), record.dayName);
+
+		if (mode == Mode::kTransitions) {
+			pendingTick = record;
+			isTickPending = true;
+		} else {
+			Emit(record);
+		}
+	}
+
+	void SkillTrace::RecordSkill(Skill skill, SkillEvent event, float level, int capLevel, const SkillProgress& progress)
+	{
+		if (mode == Mode::kTransitions) {
+			if (event == SkillEvent::kNone) {
+				return;
+			}
+			if (isTickPending) {
+				Emit(pendingTick);
+				isTickPending = false;
+			}
+		}
+
+		SkillTraceRecord record{};
+		record.type = SkillTraceRecord::Type::kSkill;
+		record.event = event;
+		record.skill = static_cast<std::uint8_t>(skill);
+		record.level = static_cast<std::int16_t>(level);
+		record.capLevel = static_cast<std::int16_t>(capLevel);
+		record.threshold = progress.levelThreshold;
+		record.xp = progress.xp;
+		Emit(record);
+	}
+
+	void SkillTrace::EndTick()
+	{
+		isTickPending = false;
+		if (mode == Mode::kFull) {
+			SkillTraceRecord record{};
+			record.type = SkillTraceRecord::Type::kEnd;
+			Emit(record);
+		}
+
+		// In synchronous mode each tick is a batch.
+		if (!async) {
+			spdlog::default_logger()->flush();
+		}
+	}
+
+	void SkillTrace::Emit(const SkillTraceRecord& record)
+	{
+		if (async) {
+			Push(record);
+		} else {
+			Format(record, lastTick);
+		}
+	}
+
+	void SkillTrace::Push(const SkillTraceRecord& record)
+	{
+		const auto index = head.load(std::memory_order_relaxed);
+		if (index - tail.load(std::memory_order_acquire) >= capacity) {
+			// Background thread can't keep up, so we'd rather lose records than stall the game.
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer[index & (capacity - 1)] = record;
+		head.store(index + 1, std::memory_order_release);
+
+		// The worker only waits while the buffer is empty, so it only has to be woken up by the first record after that.
+		// The fence pairs with the one in the worker's check, so that at least one of us sees the other's update of head or tail.
+		// Taking the lock makes sure that the worker is either still before its check of the buffer, or already waiting for the notification.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (index == tail.load(std::memory_order_relaxed)) {
+			{
+				std::scoped_lock lock(workerLock);
+			}
+			workerCondition.notify_one();
+		}
+	}
+
+	bool SkillTrace::Drain(SkillTraceRecord& tick)
+	{
+		auto       index = tail.load(std::memory_order_relaxed);
+		const auto end = head.load(std::memory_order_acquire);
+		if (index == end) {
+			return false;
+		}
+
+		for (; index != end; ++index) {
+			const auto record = buffer[index & (capacity - 1)];
+			tail.store(index + 1, std::memory_order_release);
+			Format(record, tick);
+		}
+
+		if (const auto lost = dropped.exchange(0, std::memory_order_relaxed); lost > 0) {
+			logger::warn("Skill trace dropped {} records", lost);
+		}
+
+		// The whole batch is written to the file at once.
+		spdlog::default_logger()->flush();
+		return true;
+	}
+
+	void SkillTrace::StartWorker()
+	{
+		if (worker.joinable()) {
+			return;
+		}
+
+		worker = std::jthread([this](std::stop_token token) {
+			SkillTraceRecord tick{};
+			while (true) {
+				{
+					// Woken up either by Push() or by StopWorker()'s stop request, so neither has to wait for a polling interval.
+					std::unique_lock lock(workerLock);
+					workerCondition.wait(lock, token, [this] {
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+						return head.load(std::memory_order_acquire) != tail.load(std::memory_order_relaxed);
+					});
+				}
+				if (token.stop_requested()) {
+					break;
+				}
+				Drain(tick);
+			}
+			// Flush whatever was pushed before stopping.
+			Drain(tick);
+		});
+	}
+
+	void SkillTrace::StopWorker()
+	{
+		if (worker.joinable()) {
+			worker.request_stop();
+			worker.join();
+		}
+	}
+
+	void SkillTrace::Format(const SkillTraceRecord& record, SkillTraceRecord& tick) const
+	{
+		using Type = SkillTraceRecord::Type;
+
+		const auto timestamp = [&] {
+			return std::format("{} {:.0f}:{}", tick.dayName, tick.hour, tick.minutes);
+		};
+
+		switch (record.type) {
+		case Type::kTick:
+			tick = record;
+			if (mode == Mode::kFull) {
+				logger::info("{:*^65}", " Skill Data ");
+				logger::info("[{:^13}] {} | {:^11} | {:^11} | {:^9} | {:^8}", timestamp(), "D", "Skill", "Level [Cap]", "Threshold", "XP");
+			}
+			break;
+		case Type::kSkill:
+			{
+				constexpr std::string_view statuses[] = {
+					"-",  // kNone
+					"↑",  // kUsed
+					"•",  // kStale
+					"↓",  // kDecayed
+					"⇓"   // kLevelLost
+				};
+				const auto skill = static_cast<Skill>(record.skill);
+				const auto levelInfo = std::format("{:^3}[{:^2}]", record.level, record.capLevel);
+				logger::info("[{:^13}] {} | {:^11} | {:^11} | {:^9.2f} | {:^8.2f}", timestamp(), statuses[std::to_underlying(record.event)], SkillName(skill), levelInfo, record.threshold, record.xp);
+				break;
+			}
+		case Type::kEnd:
+			logger::info("");
+			break;
+		}
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "Decay/SkillUsage.h"
+
+namespace Decay
+{
+	/// Fixed-size binary record of skill trace.
+	/// Records are cheap to produce on the game thread and are formatted into log lines later.
+	struct SkillTraceRecord
+	{
+		enum class Type : std::uint8_t
+		{
+			kTick,   // Beginning of SkillUsage update.
+			kSkill,  // State of a single skill after the update.
+			kEnd     // End of SkillUsage update.
+		};
+
+		Type         type = Type::kTick;
+		SkillEvent   event = SkillEvent::kNone;
+		std::uint8_t skill = 0;
+		std::int16_t level = 0;
+		std::int16_t capLevel = 0;
+
+		/// Values of the skill. Only used by kSkill records.
+		float threshold = 0.0f;
+		float xp = 0.0f;
+
+		/// Game time of the update. Only used by kTick records.
+		float hour = 0.0f;
+		float minutes = 0.0f;
+		char  dayName[8]{};
+	};
+	static_assert(sizeof(SkillTraceRecord) == 32);
+
+	/// Logs state of skills as they are updated by DecayTracker.
+	///
+	/// In async mode records are pushed to a ring buffer and are formatted and written to the log on a background thread,
+	/// so that logging doesn't stall the game thread with formatting and flushing.
+	class SkillTrace
+	{
+	public:
+		enum class Mode
+		{
+			kOff,
+			kFull,        // Logs a table with all updated skills on each update.
+			kTransitions  // Logs only skills that were used, became stale, decayed or lost a level.
+		};
+
+		~SkillTrace();
+
+		/// Requests a new configuration. Can be called from any thread.
+		/// The configuration only takes effect on the next ApplyConfiguration(), so that records are only ever produced by a single thread.
+		void Configure(Mode mode, bool async);
+
+		/// Applies the configuration requested by Configure(), if any.
+		/// Must be called on the thread that records the trace, before it checks IsEnabled() for a new tick.
+		void ApplyConfiguration();
+
+		bool IsEnabled() const { return mode != Mode::kOff; }
+		Mode GetMode() const { return mode; }
+		bool IsAsync() const { return async; }
+
+		/// Starts a new trace tick. Must be called before any RecordSkill() calls of the update.
+		void BeginTick(const RE::Calendar* calendar);
+
+		/// Records state of a skill. Depending on the mode, skills without any event might be skipped.
+		void RecordSkill(Skill skill, SkillEvent event, float level, int capLevel, const SkillProgress& progress);
+
+		/// Finishes current trace tick.
+		void EndTick();
+
+	private:
+		/// Number of records in the ring buffer. Must be a power of 2.
+		static constexpr std::size_t capacity = 4096;
+
+		/// Current configuration. Only changed in ApplyConfiguration() on the recording thread, while the worker is stopped.
+		Mode mode = Mode::kOff;
+		bool async = false;
+
+		/// Configuration requested by Configure(), packed as the mode and the async flag.
+		std::atomic<std::uint8_t> requestedConfig = 0;
+		std::atomic<bool>         isConfigRequested = false;
+
+		/// In kTransitions mode tick record is only emitted together with the first skill record of the tick.
+		SkillTraceRecord pendingTick{};
+		bool             isTickPending = false;
+
+		std::array<SkillTraceRecord, capacity> buffer{};
+		std::atomic<std::size_t>               head = 0;  // Next record to write. Only modified by the game thread.
+		std::atomic<std::size_t>               tail = 0;  // Next record to read. Only modified by the worker thread.
+		std::atomic<std::size_t>               dropped = 0;
+
+		std::jthread worker;
+
+		/// Condition that the worker waits on while the buffer is empty.
+		std::mutex                  workerLock;
+		std::condition_variable_any workerCondition;
+
+		/// Last kTick record formatted in synchronous mode.
+		SkillTraceRecord lastTick{};
+
+		void Emit(const SkillTraceRecord& record);
+		void Push(const SkillTraceRecord& record);
+
+		/// Formats all pushed records. Returns false if there was nothing to format.
+		bool Drain(SkillTraceRecord& tick);
+
+		/// Formats the record into the log. tick is the last kTick record that was formatted before this record.
+		void Format(const SkillTraceRecord& record, SkillTraceRecord& tick) const;
+
+		void StartWorker();
+		void StopWorker();
+	};
+}
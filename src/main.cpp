@@ -1,5 +1,9 @@
+#include "DecayAPI.h"
 #include "DecayTracker.h"
+#include "HookProfiler.h"
 #include "Hooks.h"
+#include "Options.h"
+#include "Papyrus.h"
 
 void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 {
@@ -8,6 +12,9 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 		Decay::Install();
 		Decay::DecayTracker::Register();
 		break;
+	case SKSE::MessagingInterface::kDataLoaded:
+		Decay::Settings::Resolve();
+		break;
 	case SKSE::MessagingInterface::kPostLoadGame:
 	case SKSE::MessagingInterface::kNewGame:
 		Decay::DecayTracker::GetInstance().LoadSettings();
@@ -65,14 +72,28 @@ void InitializeLog()
 	auto log = std::make_shared<spdlog::logger>("global log"s, std::move(sink));
 
 	log->set_level(spdlog::level::info);
-	log->flush_on(spdlog::level::info);
+	// Flushing every line would defeat batching of the skill trace, which flushes once per batch on its own.
+	// Everything else is flushed periodically, and problems right away.
+	log->flush_on(spdlog::level::warn);
 
 	spdlog::set_default_logger(std::move(log));
+	spdlog::flush_every(std::chrono::seconds(5));
 	spdlog::set_pattern("[%H:%M:%S:%e] %v"s);
 
 	logger::info(FMT_STRING("{} v{}"), Version::PROJECT, Version::NAME);
 }
 
+/// SKSE doesn't notify plugins when the game shuts down, so this is the only place where background threads can be released explicitly,
+/// rather than having static destructors join them while the DLL is being unloaded.
+extern "C" int __stdcall DllMain(void*, unsigned long reason, void*)
+{
+	constexpr unsigned long processDetach = 0;  // DLL_PROCESS_DETACH
+	if (reason == processDetach) {
+		Decay::HookProfiler::Shutdown();
+	}
+	return 1;
+}
+
 extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* a_skse)
 {
 	InitializeLog();
@@ -82,6 +103,8 @@ extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* a_s
 	SKSE::Init(a_skse, false);
 
 	SKSE::GetMessagingInterface()->RegisterListener(MessageHandler);
+	Decay::DecayAPI::Register();
+	SKSE::GetPapyrusInterface()->Register(Decay::Papyrus::Register);
 
 	return true;
 }
@@ -0,0 +1,63 @@
+#include "Benchmark.h"
+#include <cstdio>
+
+namespace Decay::Bench
+{
+	Stats Samples::Summarize(double overhead) const
+	{
+		Stats stats;
+		if (values.empty()) {
+			return stats;
+		}
+
+		auto sorted = values;
+		for (auto& value : sorted) {
+			value = std::max(0.0, value - overhead);
+		}
+		std::ranges::sort(sorted);
+
+		const auto percentile = [&](double p) {
+			const auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+			return sorted[index];
+		};
+
+		double sum = 0;
+		for (const auto value : sorted) {
+			sum += value;
+		}
+
+		stats.p50 = percentile(0.50);
+		stats.p99 = percentile(0.99);
+		stats.p999 = percentile(0.999);
+		stats.max = sorted.back();
+		stats.mean = sum / static_cast<double>(sorted.size());
+		return stats;
+	}
+
+	double CalibrateOverhead()
+	{
+		const auto samples = Measure(100000, [] {}, [] {});
+		return samples.Summarize().p50;
+	}
+
+	namespace
+	{
+		/// Title of the table, which is printed along with its first row, so that tables of skipped benchmarks are omitted.
+		std::string pendingHeader;
+	}
+
+	void PrintHeader(const std::string& title)
+	{
+		pendingHeader = title;
+	}
+
+	void PrintRow(const std::string& name, const Stats& stats)
+	{
+		if (!pendingHeader.empty()) {
+			std::printf("\n%s\n", pendingHeader.c_str());
+			std::printf("%-48s %10s %10s %10s %10s %10s\n", "", "p50 ns", "p99 ns", "p99.9 ns", "max ns", "mean ns");
+			pendingHeader.clear();
+		}
+		std::printf("%-48s %10.1f %10.1f %10.1f %10.1f %10.1f\n", name.c_str(), stats.p50, stats.p99, stats.p999, stats.max, stats.mean);
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Decay::Bench
+{
+	using BenchClock = std::chrono::steady_clock;
+
+	/// Distribution of measured durations in nanoseconds.
+	struct Stats
+	{
+		double p50 = 0;
+		double p99 = 0;
+		double p999 = 0;
+		double max = 0;
+		double mean = 0;
+	};
+
+	/// Collects individual samples and summarizes them into Stats.
+	class Samples
+	{
+	public:
+		explicit Samples(std::size_t capacity = 0) { values.reserve(capacity); }
+
+		void Add(double nanoseconds) { values.push_back(nanoseconds); }
+
+		std::size_t GetCount() const { return values.size(); }
+
+		/// Summarizes samples, subtracting the given measurement overhead from each of them.
+		Stats Summarize(double overhead = 0) const;
+
+	private:
+		std::vector<double> values;
+	};
+
+	/// Measures calls to the given function one by one, running setup before each call outside of the timed region.
+	template <typename Setup, typename Fn>
+	Samples Measure(std::size_t iterations, Setup&& setup, Fn&& fn)
+	{
+		Samples samples(iterations);
+		for (std::size_t i = 0; i < iterations; ++i) {
+			setup();
+			const auto start = BenchClock::now();
+			fn();
+			const auto end = BenchClock::now();
+			samples.Add(std::chrono::duration<double, std::nano>(end - start).count());
+		}
+		return samples;
+	}
+
+	/// Median cost of taking two timestamps, subtracted from measurements of very short calls.
+	double CalibrateOverhead();
+
+	/// Prevents the compiler from optimizing away a value that is otherwise unused.
+	template <typename T>
+	void DoNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const T* sink;
+		sink = &value;
+#endif
+	}
+
+	/// Starts a new results table. The header is printed along with the first row of the table.
+	void PrintHeader(const std::string& title);
+
+	/// Prints a single row of the results table.
+	void PrintRow(const std::string& name, const Stats& stats);
+}
@@ -0,0 +1,477 @@
+#include "Benchmark.h"
+#include "Decay/DecayKernel.h"
+#include "Decay/Journal.h"
+#include "Simulation.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Decay;
+using namespace Decay::Bench;
+
+namespace
+{
+	constexpr float minute = 1.0f / (24.0f * 60.0f);
+	constexpr float hour = 1.0f / 24.0f;
+
+	struct TimeJump
+	{
+		const char* name;
+		float       days;
+	};
+
+	constexpr TimeJump timeJumps[] = {
+		{ "1m", minute },
+		{ "1h", hour },
+		{ "8h", 8 * hour },
+		{ "1d", 1.0f },
+		{ "7d", 7.0f },
+		{ "30d", 30.0f }
+	};
+
+	constexpr float levels[] = { 15, 25, 50, 75, 100 };
+	constexpr int   legendaryLevels[] = { 0, 1, 5, 10 };
+
+	struct Options
+	{
+		/// Only benchmarks whose name contains the filter are run.
+		std::string filter;
+
+		std::size_t iterations = 20000;
+
+		/// Number of frames in the game loop benchmark.
+		std::size_t frames = 1000000;
+
+		/// Seed of the game loop benchmark.
+		unsigned seed = 42;
+	};
+
+	bool ShouldRun(const Options& options, std::string_view name)
+	{
+		return options.filter.empty() || name.find(options.filter) != std::string_view::npos;
+	}
+
+	/// Cost of a single SkillUsage::Decay() call depending on the skill's level, legendary level and time since the last decay.
+	void BenchDecay(const Options& options, double overhead)
+	{
+		PrintHeader("SkillUsage::Decay");
+
+		for (const auto level : levels) {
+			for (const auto legendary : legendaryLevels) {
+				for (const auto& jump : timeJumps) {
+					const auto name = "decay/level=" + std::to_string(static_cast<int>(level)) + "/legendary=" + std::to_string(legendary) + "/jump=" + jump.name;
+					if (!ShouldRun(options, name)) {
+						continue;
+					}
+
+					SimulatedPlayer player;
+					SimulatedClock  clock;
+					SkillUsageTable usages;
+					auto            usage = usages[0];
+					auto&           state = player.GetState(0);
+
+					player.SetLevel(0, level);
+					player[0].legendaryLevel = legendary;
+					usage.Init(DecayConfig(), 15, 0);
+					usage.UpdateThresholds(state);
+					usage.SetUsed(state, clock);
+					usage.MarkDecaying(clock);
+
+					const auto initialSkill = player[0];
+
+					const auto samples = Measure(
+						options.iterations,
+						[&] {
+							player[0] = initialSkill;
+							clock = SimulatedClock();
+							usage.Revert();
+							usage.SetUsed(state, clock);
+							usage.MarkDecaying(clock);
+							clock.Advance(jump.days);
+						},
+						[&] { usage.Decay(state, clock); });
+
+					PrintRow(name, samples.Summarize(overhead));
+				}
+			}
+		}
+	}
+
+	/// Cost of scheduling the next update of a skill, which evaluates its grace period and decay cap.
+	void BenchNextUpdate(const Options& options, double overhead)
+	{
+		PrintHeader("SkillUsage::GetNextUpdateTime");
+
+		for (const auto level : levels) {
+			for (const auto legendary : legendaryLevels) {
+				for (const bool decaying : { false, true }) {
+					const auto name = "next-update/level=" + std::to_string(static_cast<int>(level)) + "/legendary=" + std::to_string(legendary) + (decaying ? "/decaying" : "/grace");
+					if (!ShouldRun(options, name)) {
+						continue;
+					}
+
+					SimulatedPlayer player;
+					SimulatedClock  clock;
+					SkillUsageTable usages;
+					auto            usage = usages[0];
+					auto&           state = player.GetState(0);
+
+					player.SetLevel(0, level);
+					player[0].legendaryLevel = legendary;
+					usage.Init(DecayConfig(), 15, 0);
+					usage.UpdateThresholds(state);
+					usage.SetUsed(state, clock);
+					if (decaying) {
+						usage.MarkDecaying(clock);
+					}
+					clock.Advance(hour);
+
+					float next = 0;
+					const auto samples = Measure(
+						options.iterations,
+						[] {},
+						[&] { next = usage.GetNextUpdateTime(state, clock, 0.016f); });
+					DoNotOptimize(next);
+
+					PrintRow(name, samples.Summarize(overhead));
+				}
+			}
+		}
+	}
+
+	/// Cost of initializing all skills when settings are loaded, including rebuilding of their level thresholds.
+	void BenchSettings(const Options& options, double overhead)
+	{
+		PrintHeader("Settings");
+
+		for (const bool changed : { false, true }) {
+			const auto name = std::string("settings/init/") + (changed ? "curve-changed" : "unchanged");
+			if (!ShouldRun(options, name)) {
+				continue;
+			}
+
+			SimulatedPlayer  player;
+			SimulatedClock   clock;
+			SimulatedTracker tracker(player, clock);
+			tracker.Init(DecayConfig());
+
+			bool       flip = false;
+			const auto samples = Measure(
+				options.iterations / 10,
+				[&] {
+					if (changed) {
+						flip = !flip;
+						for (std::size_t skill = 0; skill < skillCount; ++skill) {
+							player[skill].leveling.curve = flip ? 1.90f : 1.95f;
+						}
+					}
+				},
+				[&] { tracker.Init(DecayConfig()); });
+
+			PrintRow(name, samples.Summarize(overhead));
+		}
+	}
+
+	/// Synthetic game loop at 60 FPS with the default timescale of 20.
+	/// Player occasionally uses random skills, while sleeping, waiting and fast travelling cause larger time jumps.
+	/// Reports per-frame cost of the AdvanceTime path.
+	void BenchGameLoop(const Options& options, double overhead)
+	{
+		constexpr float timescale = 20.0f;
+		constexpr float frameDays = timescale / 60.0f / (24.0f * 60.0f * 60.0f);
+
+		// On average a skill is used every 10 real seconds and time jumps happen every 10 real minutes.
+		constexpr double useChance = 1.0 / (60.0 * 10.0);
+		constexpr double jumpChance = 1.0 / (60.0 * 60.0 * 10.0);
+
+		PrintHeader("Game loop (" + std::to_string(options.frames) + " frames at 60 FPS, timescale " + std::to_string(static_cast<int>(timescale)) + ")");
+
+		const auto name = std::string("game-loop/advance-time");
+		if (!ShouldRun(options, name)) {
+			return;
+		}
+
+		std::mt19937                          random(options.seed);
+		std::uniform_real_distribution<>      chance(0.0, 1.0);
+		std::uniform_int_distribution<size_t> anySkill(0, skillCount - 1);
+		std::uniform_int_distribution<>       anyLevel(15, 100);
+		std::uniform_int_distribution<>       anyLegendary(0, 3);
+		std::uniform_int_distribution<>       anyJump(0, std::size(timeJumps) - 1);
+		std::uniform_real_distribution<float> anyXP(1.0f, 50.0f);
+
+		SimulatedPlayer  player;
+		SimulatedClock   clock(1.0f);
+		SimulatedTracker tracker(player, clock);
+
+		for (std::size_t skill = 0; skill < skillCount; ++skill) {
+			player.SetLevel(skill, static_cast<float>(anyLevel(random)));
+			player[skill].legendaryLevel = anyLegendary(random);
+		}
+		tracker.Init(DecayConfig());
+
+		Samples     all(options.frames);
+		Samples     busy;
+		std::size_t updates = 0;
+
+		for (std::size_t frame = 0; frame < options.frames; ++frame) {
+			clock.Advance(frameDays);
+
+			if (chance(random) < useChance) {
+				const auto skill = anySkill(random);
+				player.GainXP(skill, anyXP(random));
+				tracker.SkillUsed(skill);
+			}
+			if (chance(random) < jumpChance) {
+				clock.Advance(timeJumps[anyJump(random)].days);
+			}
+
+			const auto start = BenchClock::now();
+			const auto updated = tracker.AdvanceTime();
+			const auto end = BenchClock::now();
+			const auto elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+
+			all.Add(elapsed);
+			if (updated > 0) {
+				busy.Add(elapsed);
+				updates += updated;
+			}
+		}
+
+		PrintRow(name, all.Summarize(overhead));
+		PrintRow(name + "/with-updates (" + std::to_string(busy.GetCount()) + " frames)", busy.Summarize(overhead));
+		std::printf("%zu skill updates, %zu skills decaying at the end, %.1f in-game days simulated\n", updates, tracker.GetDecayingCount(), clock.GetDaysPassed() - 1.0f);
+	}
+
+	/// Cost of recording a frame to the journal: a tick and, on frames that update skills, a record per updated skill.
+	/// Runs long enough for the buffer to be written out several times, which shows up in the tail of the distribution.
+	void BenchJournal(const Options& options, double overhead)
+	{
+		PrintHeader("Journal");
+
+		const auto path = std::filesystem::temp_directory_path() / "SkillDecayBench.journal";
+		for (const std::size_t skills : { std::size_t(0), std::size_t(1), skillCount }) {
+			const auto name = "journal/tick+" + std::to_string(skills) + "-skills";
+			if (!ShouldRun(options, name)) {
+				continue;
+			}
+
+			JournalWriter journal;
+			if (!journal.Open(path, 0)) {
+				std::printf("Can't open %s for writing\n", path.string().c_str());
+				return;
+			}
+
+			float      daysPassed = 1.0f;
+			const auto samples = Measure(
+				options.iterations * 10,
+				[] {},
+				[&] {
+					daysPassed += minute;
+					journal.RecordTick(daysPassed, minute);
+					for (std::size_t skill = 0; skill < skills; ++skill) {
+						journal.RecordSkill(skill, SkillEvent::kDecayed, daysPassed, 50.0f, 30, 12.5f);
+					}
+				});
+
+			PrintRow(name, samples.Summarize(overhead));
+		}
+
+		std::error_code error;
+		std::filesystem::remove(path, error);
+	}
+
+	std::vector<DecayKernelIsa> GetSupportedIsas()
+	{
+		std::vector<DecayKernelIsa> isas = { DecayKernelIsa::kScalar };
+		const auto                  best = GetSupportedDecayKernelIsa();
+		if (best >= DecayKernelIsa::kSSE4) {
+			isas.push_back(DecayKernelIsa::kSSE4);
+		}
+		if (best >= DecayKernelIsa::kAVX2) {
+			isas.push_back(DecayKernelIsa::kAVX2);
+		}
+		return isas;
+	}
+
+	/// Checks the kernel's pow() against the exact result over the documented range,
+	/// and that all instruction sets produce identical results.
+	bool VerifyPow(const Options& options)
+	{
+		if (!ShouldRun(options, "kernel/verify")) {
+			return true;
+		}
+
+		std::vector<float> x, y;
+		for (float base = 1.0f; base <= 254.0f; base += 0.25f) {
+			for (float exponent = 0.5f; exponent <= 4.0f; exponent += 0.01f) {
+				x.push_back(base);
+				y.push_back(exponent);
+			}
+		}
+
+		std::vector<float> scalar(x.size());
+		CalculatePow(x.data(), y.data(), scalar.data(), x.size(), DecayKernelIsa::kScalar);
+
+		bool ok = true;
+		for (const auto isa : GetSupportedIsas()) {
+			std::vector<float> result(x.size());
+			CalculatePow(x.data(), y.data(), result.data(), x.size(), isa);
+
+			double      maxError = 0;
+			std::size_t mismatches = 0;
+			for (std::size_t i = 0; i < x.size(); ++i) {
+				const double exact = std::pow(static_cast<double>(x[i]), static_cast<double>(y[i]));
+				maxError = std::max(maxError, std::abs(result[i] - exact) / exact);
+				mismatches += result[i] != scalar[i];
+			}
+
+			const bool isValid = maxError <= decayKernelPowError && mismatches == 0;
+			std::printf("kernel/verify/pow/%s: %zu values, max relative error %.3g (bound %.3g), %zu mismatches with scalar: %s\n",
+				GetDecayKernelIsaName(isa), x.size(), maxError, decayKernelPowError, mismatches, isValid ? "OK" : "FAILED");
+			ok &= isValid;
+		}
+		return ok;
+	}
+
+	/// Fills the batch with random, but valid parameters of all skills.
+	void FillBatch(DecayBatch& batch, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> anyHours(0.016f, 30.0f * 24.0f);
+		std::uniform_int_distribution<>       anyLevel(2, 40);
+		std::uniform_int_distribution<>       anyLegendary(0, 10);
+		std::uniform_int_distribution<>       anyDifficulty(0, 5);
+
+		constexpr float difficultyMults[] = { 1.0f, 1.25f, 1.5f, 1.75f, 2.0f, 3.0f };
+
+		for (std::size_t skill = 0; skill < skillCount; ++skill) {
+			const DecayConfig config;
+			batch.hoursPassed[skill] = anyHours(random);
+			batch.interval[skill] = config.interval;
+			batch.difficultyMult[skill] = difficultyMults[anyDifficulty(random)];
+			batch.damping[skill] = config.damping;
+			batch.legendaryMult[skill] = std::max(1.0f, 1 + (config.legendarySkillDamping - 1) * anyLegendary(random));
+			batch.targetLevel[skill] = static_cast<float>(anyLevel(random));
+			batch.improveMult[skill] = 1.0f;
+			batch.improveOffset[skill] = 0.0f;
+			batch.curve[skill] = 1.95f;
+			batch.minDaysPerLevel[skill] = config.minDaysPerLevel;
+			batch.maxDaysPerLevel[skill] = config.maxDaysPerLevel;
+		}
+	}
+
+	/// Checks decay XP calculated by the kernel against the scalar reference.
+	bool VerifyDecayXP(const Options& options)
+	{
+		if (!ShouldRun(options, "kernel/verify")) {
+			return true;
+		}
+
+		std::mt19937 random(options.seed);
+		bool         ok = true;
+		for (const auto isa : GetSupportedIsas()) {
+			double maxError = 0;
+			for (std::size_t iteration = 0; iteration < 1000; ++iteration) {
+				DecayBatch batch;
+				FillBatch(batch, random);
+
+				float reference[DecayBatch::size];
+				float result[DecayBatch::size];
+				CalculateDecayXPReference(batch, reference);
+				CalculateDecayXP(batch, result, isa);
+
+				for (std::size_t skill = 0; skill < skillCount; ++skill) {
+					maxError = std::max(maxError, std::abs(static_cast<double>(result[skill]) - reference[skill]) / reference[skill]);
+				}
+			}
+
+			// Besides the pow error, both results are rounded a few more times.
+			const double bound = decayKernelPowError + 1e-6;
+			const bool   isValid = maxError <= bound;
+			std::printf("kernel/verify/decay-xp/%s: max relative error %.3g (bound %.3g): %s\n", GetDecayKernelIsaName(isa), maxError, bound, isValid ? "OK" : "FAILED");
+			ok &= isValid;
+		}
+		return ok;
+	}
+
+	/// Cost of calculating decay XP of all skills at once.
+	void BenchDecayKernel(const Options& options, double overhead)
+	{
+		PrintHeader("Decay kernel (all skills)");
+
+		std::mt19937 random(options.seed);
+		DecayBatch   batch;
+		FillBatch(batch, random);
+
+		float decayXP[DecayBatch::size];
+
+		if (const auto name = std::string("kernel/decay-xp/reference"); ShouldRun(options, name)) {
+			const auto samples = Measure(options.iterations, [] {}, [&] { CalculateDecayXPReference(batch, decayXP); });
+			DoNotOptimize(decayXP);
+			PrintRow(name, samples.Summarize(overhead));
+		}
+
+		for (const auto isa : GetSupportedIsas()) {
+			const auto name = std::string("kernel/decay-xp/") + GetDecayKernelIsaName(isa);
+			if (!ShouldRun(options, name)) {
+				continue;
+			}
+			const auto samples = Measure(options.iterations, [] {}, [&] { CalculateDecayXP(batch, decayXP, isa); });
+			DoNotOptimize(decayXP);
+			PrintRow(name, samples.Summarize(overhead));
+		}
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: SkillDecayBench [--filter <text>] [--iterations <n>] [--frames <n>] [--seed <n>]\n"
+			"Runs all benchmarks and verifies the decay kernel against its scalar reference (use '--filter kernel/verify' to only verify).\n"
+			"  --filter      Only run benchmarks whose name contains the text.\n"
+			"  --iterations  Number of measured calls per microbenchmark (default 20000).\n"
+			"  --frames      Number of frames in the game loop benchmark (default 1000000).\n"
+			"  --seed        Seed of the game loop benchmark (default 42).\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		const bool             hasValue = i + 1 < argc;
+		if (arg == "--filter" && hasValue) {
+			options.filter = argv[++i];
+		} else if (arg == "--iterations" && hasValue) {
+			options.iterations = std::strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--frames" && hasValue) {
+			options.frames = std::strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--seed" && hasValue) {
+			options.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+		} else {
+			PrintUsage();
+			return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	const double overhead = CalibrateOverhead();
+	std::printf("Timer overhead: %.1f ns (subtracted from all results)\n", overhead);
+
+	BenchDecay(options, overhead);
+	BenchNextUpdate(options, overhead);
+	BenchSettings(options, overhead);
+	BenchGameLoop(options, overhead);
+	BenchJournal(options, overhead);
+	BenchDecayKernel(options, overhead);
+
+	std::printf("\n");
+	const bool isPowValid = VerifyPow(options);
+	const bool isDecayXPValid = VerifyDecayXP(options);
+
+	return isPowValid && isDecayXPValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
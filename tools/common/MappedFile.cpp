@@ -0,0 +1,94 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace Decay
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		LARGE_INTEGER fileSize{};
+		bool          isOpen = GetFileSizeEx(file, &fileSize);
+		if (isOpen && fileSize.QuadPart > 0) {
+			isOpen = false;
+			if (const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+				if (const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) {
+					data = static_cast<const std::byte*>(view);
+					size = static_cast<std::size_t>(fileSize.QuadPart);
+					isOpen = true;
+				}
+				// The view keeps the mapping alive on its own.
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+		return isOpen;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data) {
+			UnmapViewOfFile(data);
+		}
+		data = nullptr;
+		size = 0;
+	}
+#else
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0) {
+			return false;
+		}
+
+		struct stat info{};
+		bool        isOpen = fstat(file, &info) == 0;
+		if (isOpen && info.st_size > 0) {
+			const auto length = static_cast<std::size_t>(info.st_size);
+			void*      view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+			isOpen = view != MAP_FAILED;
+			if (isOpen) {
+				// Files are mostly walked front to back, e.g. co-saves are read exactly once.
+				madvise(view, length, MADV_SEQUENTIAL);
+				data = static_cast<const std::byte*>(view);
+				size = length;
+			}
+		}
+		// The mapping keeps the file alive on its own.
+		close(file);
+		return isOpen;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data) {
+			munmap(const_cast<std::byte*>(data), size);
+		}
+		data = nullptr;
+		size = 0;
+	}
+#endif
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace Decay
+{
+	/// Read-only memory mapping of a whole file.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/// Maps the file, returning false if it can't be opened or mapped.
+		/// Empty files are opened successfully with no data.
+		bool Open(const std::filesystem::path& path);
+
+		std::span<const std::byte> GetData() const { return { data, size }; }
+
+	private:
+		const std::byte* data = nullptr;
+		std::size_t      size = 0;
+
+		void Close();
+	};
+}
@@ -0,0 +1,195 @@
+#include "Simulation.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+
+namespace Decay
+{
+	std::size_t FindSkill(std::string_view name)
+	{
+		const auto matches = [&](std::string_view skillName) {
+			return std::ranges::equal(skillName, name, [](unsigned char a, unsigned char b) { return std::tolower(a) == std::tolower(b); });
+		};
+		return static_cast<std::size_t>(std::ranges::find_if(skillNames, matches) - skillNames.begin());
+	}
+
+	bool ParseNumber(std::string_view text, float& value)
+	{
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		return error == std::errc() && end == text.data() + text.size();
+	}
+
+	bool ParseDuration(std::string_view text, float& days)
+	{
+		if (text.empty()) {
+			return false;
+		}
+
+		float unit = 0.0f;
+		switch (text.back()) {
+		case 'm':
+			unit = 1.0f / (24.0f * 60.0f);
+			break;
+		case 'h':
+			unit = 1.0f / 24.0f;
+			break;
+		case 'd':
+			unit = 1.0f;
+			break;
+		default:
+			return false;
+		}
+
+		float count = 0.0f;
+		if (!ParseNumber(text.substr(0, text.size() - 1), count) || count < 0) {
+			return false;
+		}
+		days = count * unit;
+		return true;
+	}
+
+	bool SetConfigOption(DecayConfig& config, std::string_view key, float value)
+	{
+		struct Option
+		{
+			std::string_view key;
+			void (*set)(DecayConfig&, float);
+		};
+
+		// Same keys as ReadSettings() in the plugin reads from each skill's section.
+		constexpr Option options[] = {
+			{ "fDecayGracePeriod", [](DecayConfig& c, float v) { c.gracePeriod = v; } },
+			{ "fDecayInterval", [](DecayConfig& c, float v) { c.interval = v; } },
+			{ "iDecayLevelOffset", [](DecayConfig& c, float v) { c.levelOffset = static_cast<int>(v); } },
+			{ "iBaselineLevelOffset", [](DecayConfig& c, float v) { c.baselineLevelOffset = static_cast<int>(v); } },
+			{ "fDecayXPDamping", [](DecayConfig& c, float v) { c.damping = v; } },
+			{ "fDecayXPDifficultyMult", [](DecayConfig& c, float v) { c.difficultyMult = v; } },
+			{ "iDecayLevelCap", [](DecayConfig& c, float v) { c.levelCap = static_cast<int>(v); } },
+			{ "fLegendarySkillXPDamping", [](DecayConfig& c, float v) { c.legendarySkillDamping = v; } },
+			{ "fMinDaysPerLevel", [](DecayConfig& c, float v) { c.minDaysPerLevel = v; } },
+			{ "fMaxDaysPerLevel", [](DecayConfig& c, float v) { c.maxDaysPerLevel = v; } },
+			{ "iDifficulty", [](DecayConfig& c, float v) { c.difficultyOverride = static_cast<int>(v); } },
+		};
+
+		const auto option = std::ranges::find(options, key, &Option::key);
+		if (option == std::end(options)) {
+			return false;
+		}
+		option->set(config, value);
+		return true;
+	}
+
+	float SimulatedSkillState::GetLevel() const
+	{
+		return (*player)[skill].level;
+	}
+
+	void SimulatedSkillState::ModLevel(float delta)
+	{
+		(*player)[skill].level += delta;
+	}
+
+	SkillProgress SimulatedSkillState::GetProgress() const
+	{
+		return (*player)[skill].progress;
+	}
+
+	void SimulatedSkillState::SetProgress(const SkillProgress& progress)
+	{
+		(*player)[skill].progress = progress;
+	}
+
+	int SimulatedSkillState::GetLegendaryLevel() const
+	{
+		return (*player)[skill].legendaryLevel;
+	}
+
+	int SimulatedSkillState::GetDifficulty() const
+	{
+		return player->difficulty;
+	}
+
+	LevelingParams SimulatedSkillState::GetLeveling() const
+	{
+		return (*player)[skill].leveling;
+	}
+
+	SimulatedPlayer::SimulatedPlayer()
+	{
+		for (std::size_t skill = 0; skill < skillCount; ++skill) {
+			states[skill] = SimulatedSkillState(this, skill);
+			SetLevel(skill, skills[skill].level);
+		}
+	}
+
+	void SimulatedPlayer::SetLevel(std::size_t skill, float level)
+	{
+		auto& data = skills[skill];
+		data.level = level;
+		data.progress = { level, 0.0f, GetLevelThreshold(skill, level) };
+	}
+
+	void SimulatedPlayer::GainXP(std::size_t skill, float xp)
+	{
+		auto& data = skills[skill];
+		data.progress.xp += xp;
+		while (data.progress.xp >= data.progress.levelThreshold) {
+			data.progress.xp -= data.progress.levelThreshold;
+			data.level += 1;
+			data.progress.level = data.level;
+			data.progress.levelThreshold = GetLevelThreshold(skill, data.level);
+		}
+	}
+
+	float SimulatedPlayer::GetLevelThreshold(std::size_t skill, float level) const
+	{
+		const auto& params = skills[skill].leveling;
+		return params.improveMult * std::pow(std::max(0.0f, level - 1.0f), params.curve) + params.improveOffset;
+	}
+
+	SimulatedTracker::SimulatedTracker(SimulatedPlayer& player, const SimulatedClock& clock) :
+		player(player), clock(clock)
+	{}
+
+	void SimulatedTracker::Init(const DecayConfig& config, int baselineLevel, int raceSkillBonus)
+	{
+		for (std::size_t skill = 0; skill < skillCount; ++skill) {
+			auto  usage = skillUsages[skill];
+			usage.Revert();
+			usage.Init(config, baselineLevel, raceSkillBonus);
+			usage.UpdateThresholds(player.GetState(skill));
+		}
+		updater.ResetDecaying();
+		updater.ResetSchedule();
+	}
+
+	std::size_t SimulatedTracker::AdvanceTime()
+	{
+		const float now = clock.GetDaysPassed();
+		if (!updater.IsDue(now)) {
+			return 0;
+		}
+
+		const auto due = updater.PopDue(now);
+		Update(due);
+		return due.count();
+	}
+
+	void SimulatedTracker::SkillUsed(std::size_t skill)
+	{
+		if (skillUsages[skill].IsInitialized()) {
+			updater.SetUsed(skill, player.GetState(skill), clock);
+		}
+	}
+
+	void SimulatedTracker::UpdateAll()
+	{
+		Update(SkillUpdater::SkillSet().set());
+	}
+
+	void SimulatedTracker::Update(const SkillUpdater::SkillSet& skills)
+	{
+		updater.Update(skills, clock, [this](std::size_t skill) -> SkillState& { return player.GetState(skill); }, [](std::size_t, SkillEvent) {});
+	}
+}
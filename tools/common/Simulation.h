@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Decay/DecayConfig.h"
+#include "Decay/SkillUpdater.h"
+#include "Decay/SkillUsage.h"
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace Decay
+{
+	/// Names of the skills in the order of the game's skills, matching sections of SkillDecay.ini.
+	constexpr std::array<std::string_view, skillCount> skillNames = {
+		"OneHanded", "TwoHanded", "Archery", "Block", "Smithing", "HeavyArmor",
+		"LightArmor", "Pickpocket", "Lockpicking", "Sneaking", "Alchemy", "Speech",
+		"Alteration", "Conjuration", "Destruction", "Illusion", "Restoration", "Enchanting"
+	};
+
+	/// Finds the skill by its name, ignoring case. Returns skillCount if there is no such skill.
+	std::size_t FindSkill(std::string_view name);
+
+	/// Parses the whole text as a number.
+	bool ParseNumber(std::string_view text, float& value);
+
+	/// Parses a duration in days from a number with a unit suffix: 'm' (minutes), 'h' (hours) or 'd' (days).
+	bool ParseDuration(std::string_view text, float& days);
+
+	/// Sets an option of the config by its SkillDecay.ini key.
+	/// Returns false if the key is unknown.
+	bool SetConfigOption(DecayConfig& config, std::string_view key, float value);
+
+	/// Skill of SimulatedPlayer.
+	/// Mirrors what the game stores in Player's SkillData and the skill's Actor Value.
+	struct SimulatedSkill
+	{
+		/// Actual level of the skill.
+		float          level = 15.0f;
+		SkillProgress  progress{ 15.0f, 0.0f, 0.0f };
+		int            legendaryLevel = 0;
+		LevelingParams leveling{ 1.0f, 0.0f, 1.95f };
+	};
+
+	class SimulatedPlayer;
+
+	/// SkillState backed by one of the SimulatedPlayer's skills.
+	class SimulatedSkillState final : public SkillState
+	{
+	public:
+		SimulatedSkillState() = default;
+		SimulatedSkillState(SimulatedPlayer* player, std::size_t skill) :
+			player(player), skill(skill)
+		{}
+
+		float GetLevel() const override;
+		void  ModLevel(float delta) override;
+
+		SkillProgress GetProgress() const override;
+		void          SetProgress(const SkillProgress& progress) override;
+
+		int GetLegendaryLevel() const override;
+		int GetDifficulty() const override;
+
+		LevelingParams GetLeveling() const override;
+
+	private:
+		SimulatedPlayer* player = nullptr;
+		std::size_t      skill = 0;
+	};
+
+	/// Headless stand-in for the Player.
+	class SimulatedPlayer
+	{
+	public:
+		SimulatedPlayer();
+
+		// Skill states point back to the player.
+		SimulatedPlayer(const SimulatedPlayer&) = delete;
+		SimulatedPlayer& operator=(const SimulatedPlayer&) = delete;
+
+		/// Current game difficulty, from 0 (Novice) to 5 (Legendary).
+		int difficulty = 2;
+
+		SimulatedSkill&       operator[](std::size_t skill) { return skills[skill]; }
+		const SimulatedSkill& operator[](std::size_t skill) const { return skills[skill]; }
+
+		SkillState& GetState(std::size_t skill) { return states[skill]; }
+
+		/// Sets the skill to the given level with no progress towards the next one, as if all level ups were confirmed.
+		void SetLevel(std::size_t skill, float level);
+
+		/// Adds XP to the skill, leveling it up the same way the game does.
+		void GainXP(std::size_t skill, float xp);
+
+		/// XP required to advance from the given level.
+		float GetLevelThreshold(std::size_t skill, float level) const;
+
+	private:
+		std::array<SimulatedSkill, skillCount>      skills;
+		std::array<SimulatedSkillState, skillCount> states;
+	};
+
+	/// Clock that is advanced manually.
+	class SimulatedClock final : public Clock
+	{
+	public:
+		explicit SimulatedClock(float daysPassed = 0.0f) :
+			daysPassed(daysPassed)
+		{}
+
+		float GetDaysPassed() const override { return daysPassed; }
+
+		void Advance(float days) { daysPassed += days; }
+
+		/// Sets the time directly, e.g. to avoid accumulating rounding errors of many small Advance() calls.
+		void SetDaysPassed(float days) { daysPassed = days; }
+
+	private:
+		float daysPassed;
+	};
+
+	/// Game-independent counterpart of the plugin's DecayTracker.
+	/// Runs the same SkillUpdater against SimulatedPlayer, without UI and logging.
+	class SimulatedTracker
+	{
+	public:
+		SimulatedTracker(SimulatedPlayer& player, const SimulatedClock& clock);
+
+		/// Sets hours between SkillUsage updates of decaying skills.
+		void SetTrackingRate(float trackingRate) { updater.trackingRate = trackingRate; }
+
+		void SetMode(UpdateMode mode) { updater.mode = mode; }
+
+		SkillUsage       operator[](std::size_t skill) { return skillUsages[skill]; }
+		ConstSkillUsage  operator[](std::size_t skill) const { return skillUsages[skill]; }
+
+		/// Sets up all skills with the given config, as if settings were loaded.
+		void Init(const DecayConfig& config, int baselineLevel = 15, int raceSkillBonus = 0);
+
+		/// Called every frame. Updates skills whose deadline has passed.
+		/// Returns the number of updated skills.
+		std::size_t AdvanceTime();
+
+		/// Marks given skill as used at the current moment.
+		void SkillUsed(std::size_t skill);
+
+		/// Updates all skills regardless of their deadlines.
+		void UpdateAll();
+
+		/// Number of skills whose last update left them decaying.
+		std::size_t GetDecayingCount() const { return updater.GetDecaying().count(); }
+
+	private:
+		SimulatedPlayer&      player;
+		const SimulatedClock& clock;
+
+		SkillUsageTable skillUsages;
+		SkillUpdater    updater{ skillUsages };
+
+		void Update(const SkillUpdater::SkillSet& skills);
+	};
+}
@@ -0,0 +1,123 @@
+#include "CoSave.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Decay::CoSave
+{
+	namespace
+	{
+		constexpr std::uint32_t signature = 'S' << 24 | 'K' << 16 | 'S' << 8 | 'E';
+
+		/// Plugin blocks have their length stored only since version 2 of the format, which is the one SKSE64 writes.
+		constexpr std::uint32_t minFormatVersion = 2;
+
+		struct Header
+		{
+			std::uint32_t signature;
+			std::uint32_t formatVersion;
+			std::uint32_t skseVersion;
+			std::uint32_t runtimeVersion;
+			std::uint32_t pluginCount;
+		};
+
+		struct PluginHeader
+		{
+			std::uint32_t uid;
+			std::uint32_t recordCount;
+			std::uint32_t length;
+		};
+
+		struct RecordHeader
+		{
+			std::uint32_t type;
+			std::uint32_t version;
+			std::uint32_t length;
+		};
+
+		/// Reads a header at the offset, advancing the offset past it.
+		/// Headers are copied out, since nothing guarantees their alignment within the file.
+		template <typename T>
+		bool ReadHeader(std::span<const std::byte> data, std::size_t& offset, T& header)
+		{
+			if (data.size() - offset < sizeof(T)) {
+				return false;
+			}
+			std::memcpy(&header, data.data() + offset, sizeof(T));
+			offset += sizeof(T);
+			return true;
+		}
+	}
+
+	bool Plugin::NextRecord(std::size_t& offset, Record& record) const
+	{
+		RecordHeader header;
+		if (!ReadHeader(data, offset, header) || data.size() - offset < header.length) {
+			return false;
+		}
+
+		record = { header.type, header.version, data.subspan(offset, header.length) };
+		offset += header.length;
+		return true;
+	}
+
+	std::string FindPlugin(std::span<const std::byte> coSave, std::uint32_t uid, Plugin& plugin)
+	{
+		std::size_t offset = 0;
+		Header      header;
+		if (!ReadHeader(coSave, offset, header) || header.signature != signature) {
+			return "not an SKSE co-save";
+		}
+		if (header.formatVersion < minFormatVersion) {
+			return "unsupported co-save format version " + std::to_string(header.formatVersion);
+		}
+
+		for (std::uint32_t i = 0; i < header.pluginCount; ++i) {
+			PluginHeader pluginHeader;
+			if (!ReadHeader(coSave, offset, pluginHeader) || coSave.size() - offset < pluginHeader.length) {
+				return "truncated co-save";
+			}
+
+			if (pluginHeader.uid == uid) {
+				plugin = { pluginHeader.uid, pluginHeader.recordCount, coSave.subspan(offset, pluginHeader.length) };
+				return {};
+			}
+			offset += pluginHeader.length;
+		}
+		return "no data of plugin '" + FormatFourCC(uid) + "'";
+	}
+
+	bool RecordReader::GetNextRecordInfo(std::uint32_t& type, std::uint32_t& version, std::uint32_t& length)
+	{
+		Record record;
+		if (!plugin.NextRecord(offset, record)) {
+			remaining = {};
+			return false;
+		}
+
+		type = record.type;
+		version = record.version;
+		length = static_cast<std::uint32_t>(record.data.size());
+		remaining = record.data;
+		return true;
+	}
+
+	std::uint32_t RecordReader::ReadRecordData(void* buffer, std::uint32_t size)
+	{
+		const auto count = std::min<std::size_t>(size, remaining.size());
+		if (count > 0) {
+			std::memcpy(buffer, remaining.data(), count);
+			remaining = remaining.subspan(count);
+		}
+		return static_cast<std::uint32_t>(count);
+	}
+
+	std::string FormatFourCC(std::uint32_t code)
+	{
+		std::string result(4, ' ');
+		for (std::size_t i = 0; i < 4; ++i) {
+			const auto character = static_cast<char>(code >> (24 - 8 * i));
+			result[i] = character >= 0x20 && character < 0x7F ? character : '?';
+		}
+		return result;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+/// Zero-copy reading of SKSE co-saves (.skse files).
+///
+/// A co-save is a header followed by a block per plugin, and each block is a sequence of records:
+///
+///     Header       { signature 'SKSE', formatVersion, skseVersion, runtimeVersion, pluginCount }
+///     PluginHeader { uid, recordCount, length }  - length covers all records of the plugin, including their headers
+///     RecordHeader { type, version, length }     - followed by length bytes of record data
+///
+/// All values are little-endian 32-bit integers.
+namespace Decay::CoSave
+{
+	struct Record
+	{
+		std::uint32_t              type;
+		std::uint32_t              version;
+		std::span<const std::byte> data;
+	};
+
+	/// Records of a single plugin, pointing directly into the co-save data.
+	class Plugin
+	{
+	public:
+		Plugin() = default;
+		Plugin(std::uint32_t uid, std::uint32_t recordCount, std::span<const std::byte> data) :
+			uid(uid), recordCount(recordCount), data(data) {}
+
+		std::uint32_t GetUID() const { return uid; }
+		std::uint32_t GetRecordCount() const { return recordCount; }
+
+		/// Reads the next record, returning false when there are no more records or the rest of the block is malformed.
+		/// offset is the position within the plugin's data and must start at 0.
+		bool NextRecord(std::size_t& offset, Record& record) const;
+
+	private:
+		std::uint32_t              uid = 0;
+		std::uint32_t              recordCount = 0;
+		std::span<const std::byte> data;
+	};
+
+	/// Finds the block of the plugin with given uid in the co-save.
+	/// Returns an empty string on success, otherwise the reason why the plugin couldn't be found.
+	std::string FindPlugin(std::span<const std::byte> coSave, std::uint32_t uid, Plugin& plugin);
+
+	/// Serialization interface over the records of a plugin, mirroring the reading part of SKSE::SerializationInterface,
+	/// so that records can be read with the same functions that the plugin uses when the game is loaded.
+	class RecordReader
+	{
+	public:
+		explicit RecordReader(const Plugin& plugin) :
+			plugin(plugin) {}
+
+		bool GetNextRecordInfo(std::uint32_t& type, std::uint32_t& version, std::uint32_t& length);
+
+		/// Copies the next size bytes of the current record and returns the number of bytes copied.
+		/// Like SKSE, reading past the end of the record copies only what is left of it.
+		std::uint32_t ReadRecordData(void* buffer, std::uint32_t size);
+
+	private:
+		const Plugin&              plugin;
+		std::size_t                offset = 0;
+		std::span<const std::byte> remaining;
+	};
+
+	/// Formats a record type or a plugin uid as 4 characters, e.g. 'SKUS'.
+	std::string FormatFourCC(std::uint32_t code);
+}
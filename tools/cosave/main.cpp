@@ -0,0 +1,353 @@
+#include "CoSave.h"
+#include "Decay/Serialization.h"
+#include "MappedFile.h"
+#include "Simulation.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace Decay;
+using namespace Decay::CoSave;
+
+namespace
+{
+	enum class Format
+	{
+		kCSV,
+		kJSON
+	};
+
+	struct Options
+	{
+		Format      format = Format::kCSV;
+		std::string output;
+		unsigned    jobs = std::max(1u, std::thread::hardware_concurrency());
+	};
+
+	/// Skill Decay's data decoded from a single co-save.
+	struct Analysis
+	{
+		std::filesystem::path file;
+
+		/// Reason why the data couldn't be read, empty when it was read successfully.
+		std::string error{};
+
+		/// Version of the last SkillUsage record in the co-save.
+		std::uint32_t version = 0;
+
+		std::bitset<skillCount>                  loaded{};
+		std::array<SkillUsageRecord, skillCount> skills{};
+	};
+
+	/// Reads SkillUsage records the same way DecayTracker::Load does, so that the result is what the game would load.
+	void Analyze(Analysis& analysis)
+	{
+		MappedFile mapped;
+		if (!mapped.Open(analysis.file)) {
+			analysis.error = "can't map the file";
+			return;
+		}
+
+		Plugin plugin;
+		if (analysis.error = FindPlugin(mapped.GetData(), serializationKey, plugin); !analysis.error.empty()) {
+			return;
+		}
+
+		SkillUsageTable  table;
+		SkillUsageLoader loader(table);
+		RecordReader     reader(plugin);
+		bool             hasRecords = false;
+
+		std::uint32_t type, version, length;
+		while (reader.GetNextRecordInfo(type, version, length)) {
+			if (type != skillUsageRecordType) {
+				continue;
+			}
+
+			hasRecords = true;
+			analysis.version = version;
+			switch (loader.Load(&reader, version, length)) {
+			case SkillUsageLoader::Result::kFailed:
+				analysis.error = "malformed SkillUsage record of version " + std::to_string(version);
+				break;
+			case SkillUsageLoader::Result::kUnsupported:
+				analysis.error = "unsupported SkillUsage version " + std::to_string(version);
+				break;
+			default:
+				break;
+			}
+		}
+
+		if (!hasRecords) {
+			analysis.error = "no SkillUsage records";
+		}
+		analysis.loaded = loader.GetLoaded();
+		analysis.skills = MakeSkillUsageRecords(table);
+	}
+
+	/// Analyzes all files on a pool of threads, each of which picks the next file as soon as it's done with the previous one.
+	void AnalyzeAll(std::vector<Analysis>& analyses, unsigned jobs)
+	{
+		std::atomic<std::size_t> next = 0;
+
+		const auto work = [&] {
+			for (auto index = next.fetch_add(1, std::memory_order_relaxed); index < analyses.size(); index = next.fetch_add(1, std::memory_order_relaxed)) {
+				Analyze(analyses[index]);
+			}
+		};
+
+		std::vector<std::jthread> workers;
+		const auto                threadCount = std::min<std::size_t>(jobs, analyses.size());
+		for (std::size_t i = 1; i < threadCount; ++i) {
+			workers.emplace_back(work);
+		}
+		work();
+	}
+
+	/// Collects co-saves from given files and directories. Directories are searched recursively for .skse files.
+	bool CollectFiles(const std::vector<std::filesystem::path>& inputs, std::vector<Analysis>& analyses)
+	{
+		const auto isCoSave = [](const std::filesystem::path& path) {
+			auto extension = path.extension().string();
+			std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return extension == ".skse";
+		};
+
+		std::vector<std::filesystem::path> files;
+		for (const auto& input : inputs) {
+			std::error_code error;
+			if (std::filesystem::is_directory(input, error)) {
+				for (auto it = std::filesystem::recursive_directory_iterator(input, std::filesystem::directory_options::skip_permission_denied, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+					if (it->is_regular_file(error) && isCoSave(it->path())) {
+						files.push_back(it->path());
+					}
+				}
+			} else if (std::filesystem::exists(input, error)) {
+				files.push_back(input);
+			}
+
+			if (error) {
+				std::fprintf(stderr, "Can't read %s: %s\n", input.string().c_str(), error.message().c_str());
+				return false;
+			}
+		}
+
+		std::ranges::sort(files);
+		for (auto& file : files) {
+			analyses.push_back({ .file = std::move(file) });
+		}
+		return true;
+	}
+
+	std::string FormatNumber(float value)
+	{
+		char buffer[32];
+		const auto [end, error] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+		return error == std::errc() ? std::string(buffer, end) : std::string();
+	}
+
+	std::string QuoteCSV(const std::string& value)
+	{
+		if (value.find_first_of(",\"\n\r") == std::string::npos) {
+			return value;
+		}
+		std::string quoted = "\"";
+		for (const char c : value) {
+			quoted += c;
+			if (c == '"') {
+				quoted += '"';
+			}
+		}
+		return quoted + "\"";
+	}
+
+	std::string QuoteJSON(const std::string& value)
+	{
+		std::string quoted = "\"";
+		for (const char c : value) {
+			switch (c) {
+			case '"':
+				quoted += "\\\"";
+				break;
+			case '\\':
+				quoted += "\\\\";
+				break;
+			case '\n':
+				quoted += "\\n";
+				break;
+			case '\r':
+				quoted += "\\r";
+				break;
+			case '\t':
+				quoted += "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					char escaped[8];
+					std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+					quoted += escaped;
+				} else {
+					quoted += c;
+				}
+			}
+		}
+		return quoted + "\"";
+	}
+
+	/// JSON has no representation of NaN or infinity, so they are written as null.
+	std::string FormatJSONNumber(float value)
+	{
+		return std::isfinite(value) ? FormatNumber(value) : "null";
+	}
+
+	void WriteCSV(std::FILE* out, const std::vector<Analysis>& analyses)
+	{
+		std::fputs("file,status,version,skill,name,loaded,daysPassedWhenLastUsed,daysPassedSinceLastDecay,lastKnownLevel,lastKnownXP,lastKnownLegendaryLevel,lastKnownHighestLevel,isDecaying\n", out);
+		for (const auto& analysis : analyses) {
+			const auto file = QuoteCSV(analysis.file.string());
+			const auto status = QuoteCSV(analysis.error.empty() ? "ok" : analysis.error);
+			if (analysis.version == 0) {
+				std::fprintf(out, "%s,%s,,,,,,,,,,,\n", file.c_str(), status.c_str());
+				continue;
+			}
+
+			for (const auto& skill : analysis.skills) {
+				std::fprintf(out, "%s,%s,%u,%u,%s,%d,%s,%s,%d,%s,%d,%d,%d\n",
+					file.c_str(),
+					status.c_str(),
+					analysis.version,
+					skill.skill,
+					skillNames[skill.skill].data(),
+					analysis.loaded[skill.skill] ? 1 : 0,
+					FormatNumber(skill.daysPassedWhenLastUsed).c_str(),
+					FormatNumber(skill.daysPassedSinceLastDecay).c_str(),
+					skill.lastKnownLevel,
+					FormatNumber(skill.lastKnownXP).c_str(),
+					skill.lastKnownLegendaryLevel,
+					skill.lastKnownHighestLevel,
+					skill.isDecaying);
+			}
+		}
+	}
+
+	void WriteJSON(std::FILE* out, const std::vector<Analysis>& analyses)
+	{
+		std::fputs("[", out);
+		for (std::size_t i = 0; i < analyses.size(); ++i) {
+			const auto& analysis = analyses[i];
+			std::fprintf(out, "%s\n  {\"file\": %s, \"status\": %s, \"version\": %u, \"skills\": [",
+				i > 0 ? "," : "",
+				QuoteJSON(analysis.file.string()).c_str(),
+				QuoteJSON(analysis.error.empty() ? "ok" : analysis.error).c_str(),
+				analysis.version);
+
+			if (analysis.version != 0) {
+				for (const auto& skill : analysis.skills) {
+					std::fprintf(out, "%s\n    {\"skill\": %u, \"name\": \"%s\", \"loaded\": %s, \"daysPassedWhenLastUsed\": %s, \"daysPassedSinceLastDecay\": %s, \"lastKnownLevel\": %d, \"lastKnownXP\": %s, \"lastKnownLegendaryLevel\": %d, \"lastKnownHighestLevel\": %d, \"isDecaying\": %s}",
+						skill.skill > 0 ? "," : "",
+						skill.skill,
+						skillNames[skill.skill].data(),
+						analysis.loaded[skill.skill] ? "true" : "false",
+						FormatJSONNumber(skill.daysPassedWhenLastUsed).c_str(),
+						FormatJSONNumber(skill.daysPassedSinceLastDecay).c_str(),
+						skill.lastKnownLevel,
+						FormatJSONNumber(skill.lastKnownXP).c_str(),
+						skill.lastKnownLegendaryLevel,
+						skill.lastKnownHighestLevel,
+						skill.isDecaying ? "true" : "false");
+				}
+				std::fputs("\n  ", out);
+			}
+			std::fputs("]}", out);
+		}
+		std::fputs("\n]\n", out);
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: SkillDecayCoSave [--format csv|json] [--output <file>] [--jobs <n>] <co-save or directory>...\n"
+			"Decodes Skill Decay's SkillUsage records from SKSE co-saves (.skse) the same way the game loads them.\n"
+			"  --format  Output format (default csv). CSV has a row per skill, JSON an object per co-save.\n"
+			"  --output  File to write the output to (default stdout).\n"
+			"  --jobs    Number of co-saves analyzed in parallel (default number of hardware threads).\n"
+			"Directories are searched recursively for .skse files.\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options                            options;
+	std::vector<std::filesystem::path> inputs;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		const bool             hasValue = i + 1 < argc;
+		if (arg == "--format" && hasValue) {
+			const std::string_view format = argv[++i];
+			if (format == "csv") {
+				options.format = Format::kCSV;
+			} else if (format == "json") {
+				options.format = Format::kJSON;
+			} else {
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		} else if (arg == "--output" && hasValue) {
+			options.output = argv[++i];
+		} else if (arg == "--jobs" && hasValue) {
+			options.jobs = std::max(1u, static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+		} else if (!arg.starts_with("--")) {
+			inputs.emplace_back(arg);
+		} else {
+			PrintUsage();
+			return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (inputs.empty()) {
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Analysis> analyses;
+	if (!CollectFiles(inputs, analyses)) {
+		return EXIT_FAILURE;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	AnalyzeAll(analyses, options.jobs);
+	const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::FILE* out = stdout;
+	if (!options.output.empty() && !(out = std::fopen(options.output.c_str(), "w"))) {
+		std::fprintf(stderr, "Can't open %s for writing\n", options.output.c_str());
+		return EXIT_FAILURE;
+	}
+
+	if (options.format == Format::kJSON) {
+		WriteJSON(out, analyses);
+	} else {
+		WriteCSV(out, analyses);
+	}
+
+	if (out != stdout) {
+		std::fclose(out);
+	}
+
+	const auto failed = std::ranges::count_if(analyses, [](const Analysis& analysis) { return !analysis.error.empty(); });
+	std::fprintf(stderr, "Analyzed %zu co-saves in %.1f ms using %u threads, %td without valid Skill Decay data\n", analyses.size(), elapsed, std::min<unsigned>(options.jobs, static_cast<unsigned>(std::max<std::size_t>(1, analyses.size()))), failed);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+#include "Decay/Journal.h"
+#include "MappedFile.h"
+#include "Simulation.h"
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <limits>
+#include <string>
+#include <string_view>
+
+using namespace Decay;
+
+namespace
+{
+	struct Options
+	{
+		/// Skill to print records of, or skillCount for all skills.
+		std::size_t skill = skillCount;
+		bool        transitionsOnly = false;
+		float       from = -std::numeric_limits<float>::infinity();
+		float       to = std::numeric_limits<float>::infinity();
+
+		/// Whether records are replayed into the state of skills, which is printed instead of the records.
+		bool  replay = false;
+		float at = std::numeric_limits<float>::infinity();
+
+		std::string output;
+	};
+
+	const char* FormatType(JournalRecord::Type type)
+	{
+		switch (type) {
+		case JournalRecord::Type::kTick:
+			return "tick";
+		case JournalRecord::Type::kSkill:
+			return "skill";
+		case JournalRecord::Type::kReset:
+			return "reset";
+		default:
+			return "unknown";
+		}
+	}
+
+	const char* FormatEvent(SkillEvent event)
+	{
+		switch (event) {
+		case SkillEvent::kNone:
+			return "";
+		case SkillEvent::kUsed:
+			return "used";
+		case SkillEvent::kStale:
+			return "stale";
+		case SkillEvent::kDecayed:
+			return "decayed";
+		case SkillEvent::kLevelLost:
+			return "level lost";
+		default:
+			return "unknown";
+		}
+	}
+
+	const char* FormatSkill(std::size_t skill)
+	{
+		return skill < skillCount ? skillNames[skill].data() : "unknown";
+	}
+
+	bool IsPrinted(const Options& options, const JournalRecord& record)
+	{
+		if (record.daysPassed < options.from || record.daysPassed > options.to) {
+			return false;
+		}
+		if (record.type != JournalRecord::Type::kSkill) {
+			return !options.transitionsOnly && options.skill == skillCount;
+		}
+		return (options.skill == skillCount || record.skill == options.skill) && (!options.transitionsOnly || record.event != SkillEvent::kNone);
+	}
+
+	void WriteRecords(std::FILE* out, const Options& options, const JournalReader& reader)
+	{
+		std::fputs("index,type,daysPassed,delta,skill,event,level,cap,xp\n", out);
+		for (std::size_t i = 0; i < reader.GetRecordCount(); ++i) {
+			const auto record = reader.GetRecord(i);
+			if (!IsPrinted(options, record)) {
+				continue;
+			}
+
+			switch (record.type) {
+			case JournalRecord::Type::kTick:
+				std::fprintf(out, "%zu,tick,%.6f,%.6f,,,,,\n", i, record.daysPassed, record.delta);
+				break;
+			case JournalRecord::Type::kSkill:
+				std::fprintf(out, "%zu,skill,%.6f,,%s,%s,%d,%d,%.3f\n", i, record.daysPassed, FormatSkill(record.skill), FormatEvent(record.event), record.level, record.capLevel, record.xp);
+				break;
+			default:
+				std::fprintf(out, "%zu,%s,%.6f,,,,,,\n", i, FormatType(record.type), record.daysPassed);
+				break;
+			}
+		}
+	}
+
+	void WriteReplay(std::FILE* out, const Options& options, const JournalReader& reader)
+	{
+		JournalState state;
+		for (std::size_t i = 0; i < reader.GetRecordCount(); ++i) {
+			const auto record = reader.GetRecord(i);
+			// Time jumps back when an earlier save is loaded, so replay stops at the first record past the moment.
+			if (record.daysPassed > options.at) {
+				break;
+			}
+			state.Apply(record);
+		}
+
+		std::fprintf(out, "# state as of day %.6f after %u resets\n", state.daysPassed, state.resetCount);
+		std::fputs("skill,level,cap,xp,lastEvent,lastEventDay,decaySteps,levelsLost\n", out);
+		for (std::size_t skill = 0; skill < skillCount; ++skill) {
+			if (options.skill != skillCount && skill != options.skill) {
+				continue;
+			}
+
+			const auto& entry = state.skills[skill];
+			if (!entry.isKnown) {
+				std::fprintf(out, "%s,,,,,,%u,%u\n", FormatSkill(skill), entry.decaySteps, entry.levelsLost);
+				continue;
+			}
+			std::fprintf(out, "%s,%d,%d,%.3f,%s,%.6f,%u,%u\n",
+				FormatSkill(skill),
+				entry.level,
+				entry.capLevel,
+				entry.xp,
+				FormatEvent(entry.lastEvent),
+				entry.daysPassedWhenLastEvent,
+				entry.decaySteps,
+				entry.levelsLost);
+		}
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: SkillDecayJournal [--skill <name>] [--transitions] [--from <day>] [--to <day>] [--replay] [--at <day>] [--output <file>] <journal>\n"
+			"Prints records of a decay journal that the plugin records when bRecordJournal is enabled, as CSV.\n"
+			"  --skill        Only print records of the skill, e.g. Sneaking.\n"
+			"  --transitions  Only print skill records with a transition (used, stale, decayed, level lost).\n"
+			"  --from, --to   Only print records within the range of in-game days passed.\n"
+			"  --replay       Replay records and print the state of each skill with its decay steps and levels lost instead.\n"
+			"  --at           Stop replaying at the given in-game day. Implies --replay.\n"
+			"  --output       File to write the output to (default stdout).\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options               options;
+	std::filesystem::path input;
+	bool                  isValid = true;
+
+	for (int i = 1; i < argc && isValid; ++i) {
+		const std::string_view arg = argv[i];
+		const bool             hasValue = i + 1 < argc;
+		if (arg == "--skill" && hasValue) {
+			options.skill = FindSkill(argv[++i]);
+			isValid = options.skill != skillCount;
+		} else if (arg == "--transitions") {
+			options.transitionsOnly = true;
+		} else if (arg == "--from" && hasValue) {
+			isValid = ParseNumber(argv[++i], options.from);
+		} else if (arg == "--to" && hasValue) {
+			isValid = ParseNumber(argv[++i], options.to);
+		} else if (arg == "--replay") {
+			options.replay = true;
+		} else if (arg == "--at" && hasValue) {
+			isValid = ParseNumber(argv[++i], options.at);
+			options.replay = true;
+		} else if (arg == "--output" && hasValue) {
+			options.output = argv[++i];
+		} else if (!arg.starts_with("--") && input.empty()) {
+			input = arg;
+		} else {
+			PrintUsage();
+			return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (!isValid || input.empty()) {
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	MappedFile mapped;
+	if (!mapped.Open(input)) {
+		std::fprintf(stderr, "Can't map %s\n", input.string().c_str());
+		return EXIT_FAILURE;
+	}
+
+	JournalReader reader;
+	if (const auto error = reader.Open(mapped.GetData()); !error.empty()) {
+		std::fprintf(stderr, "Can't read %s: %s\n", input.string().c_str(), error.c_str());
+		return EXIT_FAILURE;
+	}
+
+	std::FILE* out = stdout;
+	if (!options.output.empty() && !(out = std::fopen(options.output.c_str(), "w"))) {
+		std::fprintf(stderr, "Can't open %s for writing\n", options.output.c_str());
+		return EXIT_FAILURE;
+	}
+
+	if (options.replay) {
+		WriteReplay(out, options, reader);
+	} else {
+		WriteRecords(out, options, reader);
+	}
+
+	if (out != stdout) {
+		std::fclose(out);
+	}
+
+	const auto start = static_cast<std::time_t>(reader.GetHeader().startTime);
+	char       started[32] = "unknown time";
+	if (const auto time = std::localtime(&start)) {
+		std::strftime(started, sizeof(started), "%Y-%m-%d %H:%M:%S", time);
+	}
+	std::fprintf(stderr, "Read %zu records of a session started at %s%s\n", reader.GetRecordCount(), started, reader.IsTruncated() ? ", the last record is truncated" : "");
+	return EXIT_SUCCESS;
+}
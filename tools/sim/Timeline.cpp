@@ -0,0 +1,120 @@
+#include "Timeline.h"
+#include "Simulation.h"
+#include <algorithm>
+#include <sstream>
+#include <string_view>
+
+namespace Decay::Sim
+{
+	namespace
+	{
+		bool ParseSkills(std::string_view text, std::bitset<skillCount>& skills)
+		{
+			if (text == "all") {
+				skills.set();
+				return true;
+			}
+			const auto skill = FindSkill(text);
+			if (skill >= skillCount) {
+				return false;
+			}
+			skills.reset();
+			skills.set(skill);
+			return true;
+		}
+	}
+
+	std::string ParseTimeline(std::istream& input, Timeline& timeline)
+	{
+		using Type = Command::Type;
+
+		struct Syntax
+		{
+			std::string_view name;
+			Type             type;
+			/// Number of arguments after the command name.
+			std::size_t arguments;
+		};
+
+		constexpr Syntax syntaxes[] = {
+			{ "baseline", Type::kBaseline, 1 },
+			{ "race", Type::kRace, 2 },
+			{ "config", Type::kConfig, 3 },
+			{ "level", Type::kLevel, 2 },
+			{ "legendary", Type::kLegendary, 2 },
+			{ "difficulty", Type::kDifficulty, 1 },
+			{ "xp", Type::kXP, 2 },
+			{ "train", Type::kTrain, 6 },
+			{ "wait", Type::kWait, 1 },
+			{ "sleep", Type::kSleep, 1 },
+		};
+
+		std::string line;
+		for (std::size_t number = 1; std::getline(input, line); ++number) {
+			if (const auto comment = line.find('#'); comment != std::string::npos) {
+				line.erase(comment);
+			}
+
+			std::istringstream       stream(line);
+			std::vector<std::string> words;
+			for (std::string word; stream >> word;) {
+				words.push_back(std::move(word));
+			}
+			if (words.empty()) {
+				continue;
+			}
+
+			const auto error = [&](std::string_view message) {
+				return "line " + std::to_string(number) + ": " + std::string(message);
+			};
+
+			const auto syntax = std::ranges::find(syntaxes, words[0], &Syntax::name);
+			if (syntax == std::end(syntaxes)) {
+				return error("unknown command '" + words[0] + "'");
+			}
+			if (words.size() != syntax->arguments + 1) {
+				return error("'" + words[0] + "' expects " + std::to_string(syntax->arguments) + " arguments");
+			}
+
+			Command command{ .type = syntax->type, .line = number };
+			bool    isValid = true;
+			switch (command.type) {
+			case Type::kBaseline:
+			case Type::kDifficulty:
+				isValid = ParseNumber(words[1], command.value);
+				break;
+			case Type::kRace:
+			case Type::kLevel:
+			case Type::kLegendary:
+			case Type::kXP:
+				isValid = ParseSkills(words[1], command.skills) && ParseNumber(words[2], command.value);
+				break;
+			case Type::kConfig:
+				{
+					DecayConfig config;
+					command.key = words[2];
+					isValid = ParseSkills(words[1], command.skills) && ParseNumber(words[3], command.value);
+					if (isValid && !SetConfigOption(config, command.key, command.value)) {
+						return error("unknown config option '" + command.key + "'");
+					}
+					break;
+				}
+			case Type::kTrain:
+				isValid = ParseSkills(words[1], command.skills) && ParseNumber(words[2], command.value) &&
+				          words[3] == "every" && ParseDuration(words[4], command.period) && command.period > 0 &&
+				          words[5] == "for" && ParseDuration(words[6], command.duration);
+				break;
+			case Type::kWait:
+			case Type::kSleep:
+				isValid = ParseDuration(words[1], command.duration);
+				break;
+			}
+
+			if (!isValid) {
+				return error("invalid arguments of '" + words[0] + "'");
+			}
+			timeline.push_back(std::move(command));
+		}
+		return {};
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Decay/SkillUsage.h"
+#include <bitset>
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+/// Scripted timeline of the Player's actions.
+///
+/// A timeline is a text file with one command per line. Everything after '#' is a comment.
+/// Skills are referred to by their SkillDecay.ini section names (case-insensitive) or 'all'.
+/// Durations are numbers with a unit suffix: 'm' (minutes), 'h' (hours) or 'd' (days).
+///
+///     baseline <level>                          Starting level of skills (iAVDSkillStart).
+///     race <skill> <bonus>                      Racial bonus to the skill.
+///     config <skill> <ini key> <value>          Sets a SkillDecay.ini option of the skill, e.g. 'config all fDecayInterval 48'.
+///     level <skill> <level>                     Sets the skill level, as if with 'setav' console command.
+///     legendary <skill> <count>                 Sets the number of times the skill was made legendary.
+///     difficulty <0-5>                          Sets the game difficulty, from Novice to Legendary.
+///     xp <skill> <amount>                       Player gains XP in the skill.
+///     train <skill> <xp> every <d> for <d>      Player gains XP in the skill periodically while time passes.
+///     wait <duration>                           Time passes frame by frame.
+///     sleep <duration>                          Time jumps at once, as when sleeping, waiting or fast traveling.
+namespace Decay::Sim
+{
+	struct Command
+	{
+		enum class Type
+		{
+			kBaseline,
+			kRace,
+			kConfig,
+			kLevel,
+			kLegendary,
+			kDifficulty,
+			kXP,
+			kTrain,
+			kWait,
+			kSleep
+		};
+
+		Type type;
+
+		/// Line of the command in the timeline, used in error messages.
+		std::size_t line = 0;
+
+		/// Skills that the command applies to.
+		std::bitset<skillCount> skills{};
+
+		/// INI key of a config command.
+		std::string key{};
+
+		/// Level, XP amount, config value, etc. depending on the type of the command.
+		float value = 0.0f;
+
+		/// Duration of time-advancing commands in days.
+		float duration = 0.0f;
+
+		/// Days between XP gains of a train command.
+		float period = 0.0f;
+	};
+
+	using Timeline = std::vector<Command>;
+
+	/// Parses the timeline, returning an empty string on success, otherwise a description of the first error.
+	std::string ParseTimeline(std::istream& input, Timeline& timeline);
+}
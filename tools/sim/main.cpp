@@ -0,0 +1,306 @@
+#include "Simulation.h"
+#include "Timeline.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using namespace Decay;
+using namespace Decay::Sim;
+
+namespace
+{
+	constexpr float minute = 1.0f / (24.0f * 60.0f);
+
+	struct Options
+	{
+		/// In-game minutes between frames, i.e. calls of AdvanceTime.
+		float resolution = 1.0f;
+
+		/// Hours between updates of decaying skills, same as fTrackingRate.
+		float trackingRate = 0.016f;
+
+		UpdateMode mode = UpdateMode::kStep;
+
+		/// Days between samples of skills' trajectories.
+		float sampleInterval = 1.0f;
+
+		/// Skills whose trajectories are written.
+		std::bitset<skillCount> skills = std::bitset<skillCount>().set();
+
+		std::string timeline;
+		std::string output;
+	};
+
+	/// Plays the timeline against SimulatedTracker, writing a sample of each skill at regular intervals of in-game time.
+	class Runner
+	{
+	public:
+		Runner(const Options& options, std::FILE* out) :
+			options(options), out(out)
+		{
+			tracker.SetTrackingRate(options.trackingRate);
+			tracker.SetMode(options.mode);
+			tracker.Init(DecayConfig());
+		}
+
+		void Run(const Timeline& timeline)
+		{
+			std::fputs("day,skill,level,xp,threshold,cap,decaying\n", out);
+			Sample();
+			for (const auto& command : timeline) {
+				Execute(command);
+			}
+			Sample();
+		}
+
+		std::size_t GetFrameCount() const { return frames; }
+		std::size_t GetUpdateCount() const { return updates; }
+		double      GetDaysPassed() const { return now; }
+
+	private:
+		const Options& options;
+		std::FILE*     out;
+
+		SimulatedPlayer  player;
+		SimulatedClock   clock;
+		SimulatedTracker tracker{ player, clock };
+
+		std::array<DecayConfig, skillCount> configs{};
+		int                                 baselineLevel = 15;
+		std::array<int, skillCount>         raceSkillBonuses{};
+
+		/// Time is tracked in double precision, so that millions of frames don't accumulate rounding errors.
+		/// The clock still receives a float, as the game's GameDaysPassed is.
+		double      now = 0.0;
+		double      nextSample = 0.0;
+		std::size_t frames = 0;
+		std::size_t updates = 0;
+
+		void Execute(const Command& command)
+		{
+			using Type = Command::Type;
+
+			const auto forEachSkill = [&](auto&& fn) {
+				for (std::size_t skill = 0; skill < skillCount; ++skill) {
+					if (command.skills[skill]) {
+						fn(skill);
+					}
+				}
+			};
+
+			switch (command.type) {
+			case Type::kBaseline:
+				baselineLevel = static_cast<int>(command.value);
+				for (std::size_t skill = 0; skill < skillCount; ++skill) {
+					ApplyConfig(skill);
+				}
+				break;
+			case Type::kRace:
+				forEachSkill([&](std::size_t skill) {
+					raceSkillBonuses[skill] = static_cast<int>(command.value);
+					ApplyConfig(skill);
+				});
+				break;
+			case Type::kConfig:
+				forEachSkill([&](std::size_t skill) {
+					SetConfigOption(configs[skill], command.key, command.value);
+					ApplyConfig(skill);
+				});
+				break;
+			case Type::kLevel:
+				forEachSkill([&](std::size_t skill) { player.SetLevel(skill, command.value); });
+				break;
+			case Type::kLegendary:
+				forEachSkill([&](std::size_t skill) { player[skill].legendaryLevel = static_cast<int>(command.value); });
+				break;
+			case Type::kDifficulty:
+				player.difficulty = std::clamp(static_cast<int>(command.value), 0, 5);
+				break;
+			case Type::kXP:
+				forEachSkill([&](std::size_t skill) { GainXP(skill, command.value); });
+				break;
+			case Type::kTrain:
+				{
+					const auto end = now + command.duration;
+					while (now < end) {
+						forEachSkill([&](std::size_t skill) { GainXP(skill, command.value); });
+						Wait(std::min<double>(command.period, end - now));
+					}
+					break;
+				}
+			case Type::kWait:
+				Wait(command.duration);
+				break;
+			case Type::kSleep:
+				// The game advances the calendar in a single step and calls AdvanceTime once at the end.
+				now += command.duration;
+				Frame();
+				break;
+			}
+		}
+
+		void ApplyConfig(std::size_t skill)
+		{
+			auto usage = tracker[skill];
+			usage.Init(configs[skill], baselineLevel, raceSkillBonuses[skill]);
+			usage.UpdateThresholds(player.GetState(skill));
+		}
+
+		void GainXP(std::size_t skill, float xp)
+		{
+			player.GainXP(skill, xp);
+			tracker.SkillUsed(skill);
+		}
+
+		void Wait(double days)
+		{
+			const double frameDays = options.resolution * minute;
+			const auto   count = static_cast<std::size_t>(std::llround(days / frameDays));
+			const double start = now;
+			for (std::size_t frame = 1; frame <= count; ++frame) {
+				now = start + frame * frameDays;
+				Frame();
+			}
+			now = start + days;
+		}
+
+		void Frame()
+		{
+			clock.SetDaysPassed(static_cast<float>(now));
+			updates += tracker.AdvanceTime();
+			++frames;
+
+			if (now >= nextSample) {
+				Sample();
+			}
+		}
+
+		void Sample()
+		{
+			for (std::size_t skill = 0; skill < skillCount; ++skill) {
+				if (!options.skills[skill]) {
+					continue;
+				}
+				const auto& data = player[skill];
+				auto&       state = player.GetState(skill);
+				std::fprintf(out, "%.4f,%s,%.0f,%.2f,%.2f,%d,%d\n",
+					now,
+					skillNames[skill].data(),
+					data.level,
+					data.progress.xp,
+					data.progress.levelThreshold,
+					tracker[skill].GetDecayCapLevel(state),
+					tracker[skill].IsDecaying(state) ? 1 : 0);
+			}
+			// After a long sleep, only a single sample is written and the next one is aligned to the interval again.
+			nextSample = (std::floor(now / options.sampleInterval) + 1) * options.sampleInterval;
+		}
+	};
+
+	bool ParseSkillList(std::string_view text, std::bitset<skillCount>& skills)
+	{
+		skills.reset();
+		while (!text.empty()) {
+			const auto comma = text.find(',');
+			const auto skill = FindSkill(text.substr(0, comma));
+			if (skill >= skillCount) {
+				return false;
+			}
+			skills.set(skill);
+			text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+		}
+		return skills.any();
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: SkillDecaySim [--resolution <minutes>] [--tracking-rate <hours>] [--exact] [--sample <duration>] [--skills <a,b,...>] [--output <file>] <timeline>\n"
+			"Plays a timeline of XP gains, waits and sleeps against SkillUsage and writes CSV trajectories of skills.\n"
+			"Timeline is read from the file, or from stdin when it is '-'. See tools/sim/Timeline.h for its commands.\n"
+			"  --resolution     In-game minutes between frames (default 1).\n"
+			"  --tracking-rate  Hours between updates of decaying skills, as fTrackingRate (default 0.016).\n"
+			"  --exact          Integrate decay exactly between updates, as bExactDecay.\n"
+			"  --sample         In-game time between samples, e.g. 12h (default 1d).\n"
+			"  --skills         Comma-separated skills to write (default all).\n"
+			"  --output         File to write the trajectories to (default stdout).\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		const bool             hasValue = i + 1 < argc;
+		if (arg == "--resolution" && hasValue) {
+			options.resolution = std::strtof(argv[++i], nullptr);
+		} else if (arg == "--tracking-rate" && hasValue) {
+			options.trackingRate = std::strtof(argv[++i], nullptr);
+		} else if (arg == "--exact") {
+			options.mode = UpdateMode::kExact;
+		} else if (arg == "--sample" && hasValue) {
+			if (!ParseDuration(argv[++i], options.sampleInterval) || options.sampleInterval <= 0) {
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		} else if (arg == "--skills" && hasValue) {
+			if (!ParseSkillList(argv[++i], options.skills)) {
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		} else if (arg == "--output" && hasValue) {
+			options.output = argv[++i];
+		} else if (options.timeline.empty() && (arg == "-" || !arg.starts_with("--"))) {
+			options.timeline = arg;
+		} else {
+			PrintUsage();
+			return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (options.timeline.empty() || options.resolution <= 0 || options.trackingRate <= 0) {
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	Timeline    timeline;
+	std::string error;
+	if (options.timeline == "-") {
+		error = ParseTimeline(std::cin, timeline);
+	} else if (std::ifstream file(options.timeline); file) {
+		error = ParseTimeline(file, timeline);
+	} else {
+		error = "can't open the file";
+	}
+	if (!error.empty()) {
+		std::fprintf(stderr, "%s: %s\n", options.timeline.c_str(), error.c_str());
+		return EXIT_FAILURE;
+	}
+
+	std::FILE* out = stdout;
+	if (!options.output.empty() && !(out = std::fopen(options.output.c_str(), "w"))) {
+		std::fprintf(stderr, "Can't open %s for writing\n", options.output.c_str());
+		return EXIT_FAILURE;
+	}
+
+	Runner     runner(options, out);
+	const auto start = std::chrono::steady_clock::now();
+	runner.Run(timeline);
+	const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	if (out != stdout) {
+		std::fclose(out);
+	}
+
+	std::fprintf(stderr, "Simulated %.1f in-game days in %zu frames with %zu skill updates in %.1f ms\n", runner.GetDaysPassed(), runner.GetFrameCount(), runner.GetUpdateCount(), elapsed);
+	return EXIT_SUCCESS;
+}
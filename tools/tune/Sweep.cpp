@@ -0,0 +1,160 @@
+#include "Sweep.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Decay::Tune
+{
+	namespace
+	{
+		/// The only skill that Evaluator simulates.
+		constexpr std::size_t skill = 0;
+
+		/// SplitMix64 finalizer, which turns consecutive integers into well-mixed random bits.
+		std::uint64_t Mix(std::uint64_t x)
+		{
+			x += 0x9E3779B97F4A7C15ull;
+			x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+			x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+			return x ^ (x >> 31);
+		}
+	}
+
+	float Parameter::GetValue(float fraction) const
+	{
+		const float value = min + (max - min) * fraction;
+		return key.starts_with('i') ? std::round(value) : value;
+	}
+
+	std::size_t ParameterSpace::GetGridSize() const
+	{
+		std::size_t size = 1;
+		for (const auto& parameter : parameters) {
+			if (parameter.steps == 0 || size > std::numeric_limits<std::size_t>::max() / parameter.steps) {
+				return 0;
+			}
+			size *= parameter.steps;
+		}
+		return size;
+	}
+
+	void ParameterSpace::GetValues(std::size_t index, std::span<float> values) const
+	{
+		for (std::size_t i = 0; i < parameters.size(); ++i) {
+			const auto& parameter = parameters[i];
+			float       fraction = 0.0f;
+			if (mode == Mode::kGrid) {
+				// The index is a mixed-radix number whose digits are steps of the parameters, the first parameter being the least significant.
+				const auto step = index % parameter.steps;
+				index /= parameter.steps;
+				fraction = parameter.steps > 1 ? static_cast<float>(step) / static_cast<float>(parameter.steps - 1) : 0.0f;
+			} else {
+				// Top 24 bits fill the float's mantissa exactly, giving a uniform fraction in [0, 1).
+				fraction = static_cast<float>(Mix(seed ^ Mix(index * parameters.size() + i)) >> 40) * 0x1p-24f;
+			}
+			values[i] = parameter.GetValue(fraction);
+		}
+	}
+
+	DecayConfig ParameterSpace::MakeConfig(std::span<const float> values) const
+	{
+		auto config = base;
+		for (std::size_t i = 0; i < parameters.size(); ++i) {
+			SetConfigOption(config, parameters[i].key, values[i]);
+		}
+		return config;
+	}
+
+	Metrics Evaluator::Evaluate(const DecayConfig& config)
+	{
+		Metrics metrics;
+		MeasureDecay(config, metrics);
+		metrics.equilibriumLevel = MeasureEquilibriumLevel(config);
+		return metrics;
+	}
+
+	void Evaluator::Reset(const DecayConfig& a_config)
+	{
+		auto config = a_config;
+		// Only a single skill is simulated, so automatic offset is resolved from its own racial bonus rather than the race's largest one.
+		if (config.baselineLevelOffset < 0) {
+			config.baselineLevelOffset = scenario.raceSkillBonus;
+		}
+
+		auto  usage = skillUsages[skill];
+		auto& state = player.GetState(skill);
+
+		player.difficulty = scenario.difficulty;
+		player[skill].legendaryLevel = scenario.legendaryLevel;
+		player.SetLevel(skill, scenario.level);
+		clock.SetDaysPassed(0.0f);
+
+		usage.Revert();
+		usage.Init(config, scenario.baselineLevel, scenario.raceSkillBonus);
+		usage.UpdateThresholds(state);
+		usage.SetUsed(state, clock);
+	}
+
+	void Evaluator::MeasureDecay(const DecayConfig& config, Metrics& metrics)
+	{
+		Reset(config);
+
+		auto  usage = skillUsages[skill];
+		auto& state = player.GetState(skill);
+
+		// Updates are scheduled the same way DecayTracker does, so the grace period is skipped in a single step.
+		float level = player[skill].level;
+		while (clock.GetDaysPassed() < scenario.horizon) {
+			const float next = usage.GetNextUpdateTime(state, clock, scenario.step * 24.0f);
+			clock.SetDaysPassed(std::min(scenario.horizon, next));
+			usage.Update(state, clock, UpdateMode::kExact);
+
+			if (player[skill].level < level) {
+				level = player[skill].level;
+				if (!std::isfinite(metrics.graceDays)) {
+					metrics.graceDays = clock.GetDaysPassed();
+				} else {
+					metrics.daysPerLevel = clock.GetDaysPassed() - metrics.graceDays;
+					return;
+				}
+			}
+		}
+	}
+
+	float Evaluator::MeasureEquilibriumLevel(const DecayConfig& config)
+	{
+		Reset(config);
+
+		auto  usage = skillUsages[skill];
+		auto& state = player.GetState(skill);
+
+		const float settled = scenario.horizon * 0.75f;
+		float       nextUse = scenario.usageXP > 0 ? scenario.usagePeriod : std::numeric_limits<float>::infinity();
+		float       now = 0.0f;
+		float       level = player[skill].level;
+		double      levelDays = 0.0;
+
+		while (now < scenario.horizon) {
+			float next = std::min({ usage.GetNextUpdateTime(state, clock, scenario.step * 24.0f), nextUse, scenario.horizon });
+			if (next <= now) {
+				// Rounding of float days must never stall the simulation.
+				next = now + scenario.step;
+			}
+
+			// Level only changes on updates, so it stays the same until the next one.
+			if (next > settled) {
+				levelDays += static_cast<double>(level) * (next - std::max(now, settled));
+			}
+
+			now = next;
+			clock.SetDaysPassed(now);
+			usage.Update(state, clock, UpdateMode::kExact);
+			if (now >= nextUse) {
+				player.GainXP(skill, scenario.usageXP);
+				usage.SetUsed(state, clock);
+				nextUse += scenario.usagePeriod;
+			}
+			level = player[skill].level;
+		}
+		return static_cast<float>(levelDays / (scenario.horizon - settled));
+	}
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Decay/DecayConfig.h"
+#include "Simulation.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Decay::Tune
+{
+	/// Range of values of a single SkillDecay.ini option.
+	struct Parameter
+	{
+		std::string key;
+		float       min = 0.0f;
+		float       max = 0.0f;
+
+		/// Number of evenly spaced values of the parameter in a grid sweep, including min and max.
+		std::size_t steps = 1;
+
+		/// Value at the given fraction of the range. Integer (i-prefixed) options are rounded.
+		float GetValue(float fraction) const;
+	};
+
+	/// Set of configs that a sweep evaluates.
+	/// Configs are generated from their index on demand, so that sweeps of millions of configs don't need to store them.
+	class ParameterSpace
+	{
+	public:
+		enum class Mode
+		{
+			/// Every combination of the parameters' steps.
+			kGrid,
+			/// Values drawn uniformly from the parameters' ranges.
+			kRandom
+		};
+
+		/// Options that are not swept keep their values from the base config.
+		ParameterSpace(const DecayConfig& base, std::vector<Parameter> parameters, Mode mode = Mode::kGrid, std::uint64_t seed = 0) :
+			base(base), parameters(std::move(parameters)), mode(mode), seed(seed)
+		{}
+
+		const std::vector<Parameter>& GetParameters() const { return parameters; }
+
+		/// Number of configs in the grid, or 0 if it doesn't fit into std::size_t.
+		std::size_t GetGridSize() const;
+
+		/// Values of the parameters of the config with the given index.
+		/// Random configs depend only on the seed and the index, so they don't change with the order of evaluation.
+		void GetValues(std::size_t index, std::span<float> values) const;
+
+		DecayConfig MakeConfig(std::span<const float> values) const;
+
+	private:
+		DecayConfig            base;
+		std::vector<Parameter> parameters;
+		Mode                   mode;
+		std::uint64_t          seed;
+	};
+
+	/// Situation of the Player in which configs are evaluated.
+	struct Scenario
+	{
+		/// Level of the skill at the start.
+		float level = 50.0f;
+
+		int legendaryLevel = 0;
+		int difficulty = 2;
+		int baselineLevel = 15;
+		int raceSkillBonus = 0;
+
+		/// XP that the Player gains in the skill every usagePeriod days. 0 means that the skill is never used.
+		float usageXP = 0.0f;
+		float usagePeriod = 1.0f;
+
+		/// Days that the skill is simulated for.
+		float horizon = 365.0f;
+
+		/// Days between updates of the skill, like fTrackingRate.
+		/// Decay is integrated exactly between updates, so this only affects the resolution of the metrics.
+		float step = 1.0f / 24.0f;
+	};
+
+	/// How a config behaves in the Scenario.
+	struct Metrics
+	{
+		/// Days it takes the unused skill to lose its first level.
+		/// Skills start without progress towards the next level, so this is mostly the grace period.
+		/// Infinity if it doesn't lose a level within the horizon.
+		float graceDays = std::numeric_limits<float>::infinity();
+
+		/// Days it then takes the skill to lose the next level, i.e. to decay a full level of XP.
+		/// Infinity if it doesn't lose another level within the horizon.
+		float daysPerLevel = std::numeric_limits<float>::infinity();
+
+		/// Average level of the skill over the last quarter of the horizon while it is used as the Scenario describes.
+		float equilibriumLevel = 0.0f;
+	};
+
+	/// Evaluates configs against the real SkillUsage on a single simulated skill.
+	/// Each thread needs its own Evaluator.
+	class Evaluator
+	{
+	public:
+		explicit Evaluator(const Scenario& scenario) :
+			scenario(scenario)
+		{}
+
+		Metrics Evaluate(const DecayConfig& config);
+
+	private:
+		const Scenario& scenario;
+
+		SimulatedPlayer player;
+		SimulatedClock  clock;
+		SkillUsageTable skillUsages;
+
+		/// Puts the skill into the Scenario's starting state with the given config, as if it was just used.
+		void Reset(const DecayConfig& config);
+
+		void  MeasureDecay(const DecayConfig& config, Metrics& metrics);
+		float MeasureEquilibriumLevel(const DecayConfig& config);
+	};
+}
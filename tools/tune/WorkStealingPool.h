@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Decay::Tune
+{
+	/// Runs loops over ranges of indices on a pool of threads.
+	///
+	/// Each thread starts with an equal share of the range and takes small chunks from the front of its own share.
+	/// Once its share runs out, the thread steals the back half of the largest share left,
+	/// so that threads which got cheaper indices keep helping with the rest until the whole range is done.
+	class WorkStealingPool
+	{
+	public:
+		explicit WorkStealingPool(unsigned threadCount) :
+			threadCount(std::max(1u, threadCount))
+		{}
+
+		/// Calls fn(index) exactly once for every index in [0, count), taking grain indices at a time.
+		/// Returns once all calls have finished.
+		template <typename Fn>
+		void ForEach(std::size_t count, std::size_t grain, Fn&& fn)
+		{
+			grain = std::max<std::size_t>(1, grain);
+			shareCount = std::clamp<std::size_t>((count + grain - 1) / grain, 1, threadCount);
+			shares = std::make_unique<Share[]>(shareCount);
+			for (std::size_t i = 0; i < shareCount; ++i) {
+				shares[i].begin = count * i / shareCount;
+				shares[i].end = count * (i + 1) / shareCount;
+			}
+			steals = 0;
+
+			const auto work = [&](std::size_t self) {
+				std::size_t begin, end;
+				while (Take(self, grain, begin, end) || (Steal(self) && Take(self, grain, begin, end))) {
+					for (auto index = begin; index < end; ++index) {
+						fn(index);
+					}
+				}
+			};
+
+			std::vector<std::jthread> workers;
+			for (std::size_t i = 1; i < shareCount; ++i) {
+				workers.emplace_back(work, i);
+			}
+			work(0);
+		}
+
+		/// Number of threads that took part in the last ForEach().
+		std::size_t GetThreadCount() const { return shareCount; }
+
+		/// Number of times threads ran out of their own work and took some of another's in the last ForEach().
+		std::size_t GetStealCount() const { return steals.load(std::memory_order_relaxed); }
+
+	private:
+		/// Indices that are yet to be processed by a thread.
+		/// Aligned to a cache line, so that threads taking from their own shares don't contend.
+		struct alignas(64) Share
+		{
+			std::mutex  mutex;
+			std::size_t begin = 0;
+			std::size_t end = 0;
+		};
+
+		unsigned                 threadCount;
+		std::size_t              shareCount = 0;
+		std::unique_ptr<Share[]> shares;
+		std::atomic<std::size_t> steals = 0;
+
+		bool Take(std::size_t self, std::size_t grain, std::size_t& begin, std::size_t& end)
+		{
+			auto&            share = shares[self];
+			std::scoped_lock lock(share.mutex);
+			if (share.begin == share.end) {
+				return false;
+			}
+			begin = share.begin;
+			end = std::min(share.end, share.begin + grain);
+			share.begin = end;
+			return true;
+		}
+
+		/// Moves the back half of the largest share left into the thread's own (empty) share.
+		/// Returns false once there is nothing left to steal.
+		bool Steal(std::size_t self)
+		{
+			while (true) {
+				std::size_t victim = self;
+				std::size_t largest = 0;
+				for (std::size_t i = 0; i < shareCount; ++i) {
+					if (i == self) {
+						continue;
+					}
+					std::scoped_lock lock(shares[i].mutex);
+					if (const auto size = shares[i].end - shares[i].begin; size > largest) {
+						victim = i;
+						largest = size;
+					}
+				}
+				if (victim == self) {
+					return false;
+				}
+
+				// Both shares are locked at once, so that the stolen indices are never out of sight of other thieves.
+				std::scoped_lock lock(shares[victim].mutex, shares[self].mutex);
+				auto&            from = shares[victim];
+				if (from.begin == from.end) {
+					// The victim finished its share in the meantime, look for another one.
+					continue;
+				}
+				const auto middle = from.begin + (from.end - from.begin) / 2;
+				shares[self].begin = middle;
+				shares[self].end = from.end;
+				from.end = middle;
+				steals.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+	};
+}
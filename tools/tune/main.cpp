@@ -0,0 +1,247 @@
+#include "Sweep.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Decay;
+using namespace Decay::Tune;
+
+namespace
+{
+	/// Number of configs a thread takes from its share at a time.
+	/// Small enough for threads to steal from each other towards the end, large enough to keep the locking cost negligible.
+	constexpr std::size_t grain = 16;
+
+	struct Options
+	{
+		DecayConfig            base;
+		std::vector<Parameter> parameters;
+
+		ParameterSpace::Mode mode = ParameterSpace::Mode::kGrid;
+		std::size_t          samples = 0;
+		std::uint64_t        seed = 42;
+
+		Scenario scenario;
+
+		/// Desired metrics that configs are ranked by. Non-positive values are not used for ranking.
+		float targetDays = 0.0f;
+		float targetLevel = 0.0f;
+
+		std::size_t top = 20;
+		unsigned    jobs = std::max(1u, std::thread::hardware_concurrency());
+		std::string output;
+	};
+
+	struct Result
+	{
+		Metrics metrics;
+
+		/// Sum of relative errors of the metrics from their targets. Lower is better.
+		float score = 0.0f;
+	};
+
+	float Score(const Options& options, const Metrics& metrics)
+	{
+		float score = 0.0f;
+		if (options.targetDays > 0) {
+			score += std::abs(metrics.daysPerLevel - options.targetDays) / options.targetDays;
+		}
+		if (options.targetLevel > 0) {
+			score += std::abs(metrics.equilibriumLevel - options.targetLevel) / options.targetLevel;
+		}
+		// Configs that never lose a level when a target asks them to are ranked last rather than compared as infinities.
+		return std::isfinite(score) ? score : std::numeric_limits<float>::max();
+	}
+
+	/// Parses "<key>=<min>:<max>[:<steps>]".
+	bool ParseParameter(std::string_view text, Parameter& parameter)
+	{
+		const auto equals = text.find('=');
+		if (equals == std::string_view::npos) {
+			return false;
+		}
+		parameter.key = text.substr(0, equals);
+
+		float       bounds[3] = { 0.0f, 0.0f, 10.0f };
+		std::size_t count = 0;
+		auto        range = text.substr(equals + 1);
+		while (true) {
+			const auto colon = range.find(':');
+			if (count == std::size(bounds) || !ParseNumber(range.substr(0, colon), bounds[count++])) {
+				return false;
+			}
+			if (colon == std::string_view::npos) {
+				break;
+			}
+			range.remove_prefix(colon + 1);
+		}
+
+		DecayConfig config;
+		parameter.min = bounds[0];
+		parameter.max = bounds[1];
+		parameter.steps = static_cast<std::size_t>(bounds[2]);
+		return count >= 2 && parameter.min <= parameter.max && bounds[2] >= 1 && SetConfigOption(config, parameter.key, 0.0f);
+	}
+
+	/// Parses "<key>=<value>".
+	bool ParseSetting(std::string_view text, DecayConfig& config)
+	{
+		const auto equals = text.find('=');
+		float      value = 0.0f;
+		return equals != std::string_view::npos && ParseNumber(text.substr(equals + 1), value) && SetConfigOption(config, text.substr(0, equals), value);
+	}
+
+	void WriteResults(std::FILE* out, const Options& options, const ParameterSpace& space, const std::vector<Result>& results)
+	{
+		const auto count = std::min(options.top, results.size());
+
+		std::vector<std::size_t> ranking(results.size());
+		std::iota(ranking.begin(), ranking.end(), std::size_t{ 0 });
+		// Ties keep the order of the sweep, so that the ranking is the same regardless of the number of threads.
+		std::partial_sort(ranking.begin(), ranking.begin() + count, ranking.end(), [&](std::size_t a, std::size_t b) {
+			return results[a].score < results[b].score || (results[a].score == results[b].score && a < b);
+		});
+
+		std::fputs("rank,score", out);
+		for (const auto& parameter : space.GetParameters()) {
+			std::fprintf(out, ",%s", parameter.key.c_str());
+		}
+		std::fputs(",graceDays,daysPerLevel,equilibriumLevel\n", out);
+
+		std::vector<float> values(space.GetParameters().size());
+		for (std::size_t rank = 0; rank < count; ++rank) {
+			const auto& result = results[ranking[rank]];
+			space.GetValues(ranking[rank], values);
+
+			std::fprintf(out, "%zu,%.4f", rank + 1, result.score);
+			for (const auto value : values) {
+				std::fprintf(out, ",%g", value);
+			}
+			std::fprintf(out, ",%.3f,%.3f,%.2f\n", result.metrics.graceDays, result.metrics.daysPerLevel, result.metrics.equilibriumLevel);
+		}
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: SkillDecayTune --param <key>=<min>:<max>[:<steps>]... [options]\n"
+			"Evaluates a sweep of DecayConfigs of a single skill in parallel and ranks them by how close their metrics are to targets.\n"
+			"Sweep:\n"
+			"  --param         SkillDecay.ini option to sweep, with the number of grid steps (default 10).\n"
+			"  --set           Fixes a SkillDecay.ini option at <key>=<value> for all configs.\n"
+			"  --random        Evaluates the given number of random configs instead of the grid.\n"
+			"  --seed          Seed of random configs (default 42).\n"
+			"Scenario:\n"
+			"  --level         Starting level of the skill (default 50).\n"
+			"  --legendary     Number of times the skill was made legendary (default 0).\n"
+			"  --difficulty    Game difficulty, from 0 (Novice) to 5 (Legendary) (default 2).\n"
+			"  --race          Racial bonus to the skill (default 0).\n"
+			"  --usage         XP gained in the skill and the time between gains, e.g. '--usage 100 2d' (default never used).\n"
+			"  --horizon       In-game time each config is simulated for (default 365d).\n"
+			"  --step          In-game time between updates, as fTrackingRate (default 1h).\n"
+			"Ranking:\n"
+			"  --target-days   Desired days for the unused skill to lose a full level once it is decaying.\n"
+			"  --target-level  Desired average level of the skill over the last quarter of the horizon under --usage.\n"
+			"  --top           Number of best configs to write (default 20).\n"
+			"  --jobs          Number of threads (default number of hardware threads).\n"
+			"  --output        File to write the ranking to (default stdout).\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	bool    isValid = true;
+
+	for (int i = 1; i < argc && isValid; ++i) {
+		const std::string_view arg = argv[i];
+		const bool             hasValue = i + 1 < argc;
+		if (arg == "--param" && hasValue) {
+			isValid = ParseParameter(argv[++i], options.parameters.emplace_back());
+		} else if (arg == "--set" && hasValue) {
+			isValid = ParseSetting(argv[++i], options.base);
+		} else if (arg == "--random" && hasValue) {
+			options.mode = ParameterSpace::Mode::kRandom;
+			options.samples = std::strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--seed" && hasValue) {
+			options.seed = std::strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--level" && hasValue) {
+			isValid = ParseNumber(argv[++i], options.scenario.level);
+		} else if (arg == "--legendary" && hasValue) {
+			options.scenario.legendaryLevel = std::atoi(argv[++i]);
+		} else if (arg == "--difficulty" && hasValue) {
+			options.scenario.difficulty = std::clamp(std::atoi(argv[++i]), 0, 5);
+		} else if (arg == "--race" && hasValue) {
+			options.scenario.raceSkillBonus = std::atoi(argv[++i]);
+		} else if (arg == "--usage" && i + 2 < argc) {
+			isValid = ParseNumber(argv[++i], options.scenario.usageXP) && ParseDuration(argv[++i], options.scenario.usagePeriod) && options.scenario.usagePeriod > 0;
+		} else if (arg == "--horizon" && hasValue) {
+			isValid = ParseDuration(argv[++i], options.scenario.horizon) && options.scenario.horizon > 0;
+		} else if (arg == "--step" && hasValue) {
+			isValid = ParseDuration(argv[++i], options.scenario.step) && options.scenario.step > 0;
+		} else if (arg == "--target-days" && hasValue) {
+			isValid = ParseNumber(argv[++i], options.targetDays);
+		} else if (arg == "--target-level" && hasValue) {
+			isValid = ParseNumber(argv[++i], options.targetLevel);
+		} else if (arg == "--top" && hasValue) {
+			options.top = std::strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--jobs" && hasValue) {
+			options.jobs = std::max(1u, static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+		} else if (arg == "--output" && hasValue) {
+			options.output = argv[++i];
+		} else {
+			PrintUsage();
+			return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (!isValid || options.parameters.empty()) {
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	const ParameterSpace space(options.base, options.parameters, options.mode, options.seed);
+	const auto           count = options.mode == ParameterSpace::Mode::kGrid ? space.GetGridSize() : options.samples;
+	if (count == 0) {
+		std::fprintf(stderr, "Nothing to evaluate, the grid is too large or no random configs were requested\n");
+		return EXIT_FAILURE;
+	}
+
+	std::FILE* out = stdout;
+	if (!options.output.empty() && !(out = std::fopen(options.output.c_str(), "w"))) {
+		std::fprintf(stderr, "Can't open %s for writing\n", options.output.c_str());
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Result> results(count);
+	WorkStealingPool    pool(options.jobs);
+
+	const auto start = std::chrono::steady_clock::now();
+	pool.ForEach(count, grain, [&](std::size_t index) {
+		// Evaluators are expensive to construct, so each thread keeps its own for the whole sweep.
+		thread_local Evaluator          evaluator(options.scenario);
+		thread_local std::vector<float> values;
+
+		values.resize(space.GetParameters().size());
+		space.GetValues(index, values);
+		const auto metrics = evaluator.Evaluate(space.MakeConfig(values));
+		results[index] = { metrics, Score(options, metrics) };
+	});
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	WriteResults(out, options, space, results);
+
+	if (out != stdout) {
+		std::fclose(out);
+	}
+
+	std::fprintf(stderr, "Evaluated %zu configs in %.2f s (%.0f configs/s) on %zu threads with %zu steals\n", count, elapsed, count / elapsed, pool.GetThreadCount(), pool.GetStealCount());
+	return EXIT_SUCCESS;
+}